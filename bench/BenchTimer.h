@@ -0,0 +1,30 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+
+// Timing helpers for the benchmarks. Each benchmark is a plain executable
+// that prints its numbers; build in Release and run it by hand.
+
+namespace GravityPaint {
+
+// Results written here can't be optimized away
+inline volatile float g_benchSink = 0.0f;
+
+// Best of several rounds of `iterations` calls, in seconds per call. The
+// minimum is the least disturbed by the scheduler and cache state.
+template <typename Fn>
+double timeBest(Fn&& fn, int iterations, int rounds = 5) {
+    double best = 1e30;
+    for (int round = 0; round < rounds; ++round) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            fn();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        best = std::min(best, seconds / iterations);
+    }
+    return best;
+}
+
+} // namespace GravityPaint
@@ -0,0 +1,201 @@
+#include "GravityPaint/physics/DeformableSurface.h"
+#include "BenchTimer.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace GravityPaint;
+
+namespace {
+
+// The array-of-structs solver DeformableSurface used before its nodes
+// and springs moved to SoA arrays, kept here as the baseline: same mesh,
+// same springs, four explicit substeps, one spring at a time.
+class AosSurface {
+public:
+    AosSurface(const Vec2& position, float width, float height, int resolutionX, int resolutionY) {
+        float cellWidth = width / (resolutionX - 1);
+        float cellHeight = height / (resolutionY - 1);
+        float diagLength = std::sqrt(cellWidth * cellWidth + cellHeight * cellHeight);
+
+        for (int y = 0; y < resolutionY; ++y) {
+            for (int x = 0; x < resolutionX; ++x) {
+                Node node;
+                node.position = Vec2(position.x - width / 2 + x * cellWidth, position.y - height / 2 + y * cellHeight);
+                node.restPosition = node.position;
+                node.isFixed = y == 0 || y == resolutionY - 1 || x == 0 || x == resolutionX - 1;
+                m_nodes.push_back(node);
+            }
+        }
+
+        for (int y = 0; y < resolutionY; ++y) {
+            for (int x = 0; x < resolutionX; ++x) {
+                int index = y * resolutionX + x;
+                if (x < resolutionX - 1) addSpring(index, index + 1, cellWidth, 1.0f);
+                if (y < resolutionY - 1) addSpring(index, index + resolutionX, cellHeight, 1.0f);
+                if (x < resolutionX - 1 && y < resolutionY - 1) {
+                    addSpring(index, index + resolutionX + 1, diagLength, 0.5f);
+                    addSpring(index + 1, index + resolutionX, diagLength, 0.5f);
+                }
+            }
+        }
+    }
+
+    void applyImpact(const Vec2& point, float force) {
+        const float impactRadius = 50.0f;
+        for (auto& node : m_nodes) {
+            if (node.isFixed) continue;
+            Vec2 toNode = node.position - point;
+            float distSq = toNode.lengthSquared();
+            if (distSq < impactRadius * impactRadius && distSq > 0.0001f) {
+                float falloff = 1.0f - std::sqrt(distSq) / impactRadius;
+                node.velocity += toNode.normalized() * force * falloff * falloff * 0.5f;
+            }
+        }
+    }
+
+    void update(float deltaTime) {
+        float subDt = deltaTime / 4;
+        for (int s = 0; s < 4; ++s) {
+            updatePhysics(subDt);
+        }
+    }
+
+    float firstNodeX() const { return m_nodes[0].position.x; }
+
+private:
+    struct Node {
+        Vec2 position;
+        Vec2 restPosition;
+        Vec2 velocity;
+        float mass = 1.0f;
+        bool isFixed = false;
+    };
+
+    struct Spring {
+        int nodeA;
+        int nodeB;
+        float restLength;
+        float stiffness;
+        float damping;
+    };
+
+    void addSpring(int a, int b, float restLength, float scale) {
+        m_springs.push_back(Spring{a, b, restLength, 500.0f * scale, 10.0f * scale});
+    }
+
+    void updatePhysics(float deltaTime) {
+        for (const auto& spring : m_springs) {
+            Node& nodeA = m_nodes[spring.nodeA];
+            Node& nodeB = m_nodes[spring.nodeB];
+
+            Vec2 delta = nodeB.position - nodeA.position;
+            float length = delta.length();
+            if (length < 0.0001f) continue;
+
+            Vec2 direction = delta / length;
+            Vec2 springForce = direction * (length - spring.restLength) * spring.stiffness;
+            Vec2 dampingForce = direction * (nodeB.velocity - nodeA.velocity).dot(direction) * spring.damping;
+            Vec2 totalForce = springForce + dampingForce;
+
+            if (!nodeA.isFixed) nodeA.velocity += totalForce * (deltaTime / nodeA.mass);
+            if (!nodeB.isFixed) nodeB.velocity -= totalForce * (deltaTime / nodeB.mass);
+        }
+
+        for (auto& node : m_nodes) {
+            if (node.isFixed) continue;
+            node.velocity += (node.restPosition - node.position) * (0.8f * deltaTime);
+            node.velocity *= 0.98f;
+            node.position += node.velocity * deltaTime;
+        }
+    }
+
+    std::vector<Node> m_nodes;
+    std::vector<Spring> m_springs;
+};
+
+} // namespace
+
+// One explicit-spring frame (four substeps) per resolution: the old AoS
+// loop against the SoA stencil solver, which walks each spring direction
+// row by row four anchors at a time. The whole surface is kept awake so
+// every spring is solved; the SoA side includes the rest check and grid
+// rebuild that follow each awake update.
+int main() {
+    const float dt = 1.0f / 60.0f;
+    const struct {
+        int x, y;
+    } resolutions[] = {{10, 5}, {20, 10}, {40, 20}, {80, 40}};
+
+    std::printf("%-8s %8s %10s %10s %8s\n", "res", "springs", "aos us", "soa us", "speedup");
+
+    for (const auto& res : resolutions) {
+        const Vec2 center(400.0f, 300.0f);
+        const float width = 400.0f;
+        const float height = 200.0f;
+        int iterations = 200000 / (res.x * res.y);
+
+        AosSurface aos(center, width, height, res.x, res.y);
+        aos.applyImpact(center, 200.0f);
+        double aosTime = timeBest([&]() {
+            aos.update(dt);
+            g_benchSink = aos.firstNodeX();
+        }, iterations);
+
+        DeformableSurface soa(center, width, height, res.x, res.y);
+        soa.applyImpact(center, 200.0f);
+        double soaTime = timeBest([&]() {
+            soa.wakeColumns(0, res.x - 1);
+            soa.update(dt);
+            g_benchSink = soa.getNodePosition(0).x;
+        }, iterations);
+
+        char label[16];
+        std::snprintf(label, sizeof(label), "%dx%d", res.x, res.y);
+        std::printf("%-8s %8zu %10.2f %10.2f %7.2fx\n", label, soa.getSpringCount(),
+                    aosTime * 1e6, soaTime * 1e6, aosTime / soaTime);
+    }
+
+    // A level's worth of 40x20 surfaces: all ten at rest, all ten kept
+    // awake, and a single one from an impact until it is asleep again
+    std::printf("\n40x20 surfaces, us per frame\n");
+    std::printf("%-12s %10s %8s\n", "surfaces", "us/frame", "frames");
+
+    std::vector<DeformableSurface> surfaces;
+    surfaces.reserve(10);
+    for (int i = 0; i < 10; ++i) {
+        surfaces.emplace_back(Vec2(200.0f + 450.0f * static_cast<float>(i), 300.0f), 400.0f, 200.0f, 40, 20);
+    }
+
+    double idleTime = timeBest([&]() {
+        for (DeformableSurface& surface : surfaces) {
+            surface.update(dt);
+        }
+        g_benchSink = surfaces[0].getNodePosition(0).x;
+    }, 20000);
+    std::printf("%-12s %10.3f %8s\n", "10 idle", idleTime * 1e6, "-");
+
+    double awakeTime = timeBest([&]() {
+        for (DeformableSurface& surface : surfaces) {
+            surface.wakeColumns(0, 39);
+            surface.update(dt);
+        }
+        g_benchSink = surfaces[0].getNodePosition(0).x;
+    }, 200);
+    std::printf("%-12s %10.3f %8s\n", "10 awake", awakeTime * 1e6, "-");
+
+    DeformableSurface& impacted = surfaces[0];
+    int settleFrames = 0;
+    double impactTime = timeBest([&]() {
+        impacted.reset();
+        impacted.applyImpact(impacted.getPosition(), 200.0f);
+        settleFrames = 0;
+        while (impacted.isAwake() && settleFrames < 6000) {
+            impacted.update(dt);
+            ++settleFrames;
+        }
+        g_benchSink = impacted.getNodePosition(0).x;
+    }, 5);
+    std::printf("%-12s %10.3f %8d\n", "1 impacted", impactTime * 1e6 / settleFrames, settleFrames);
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "GravityPaint/physics/PhysicsWorld.h"
+#include "GravityPaint/physics/PhysicsObject.h"
+#include "GravityPaint/physics/GravityField.h"
+#include "GravityPaint/Constants.h"
+#include "BenchTimer.h"
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace GravityPaint;
+
+// How field evaluation scales with the field count at a fixed 500
+// objects. "brute" is the old loop, every object against every field
+// through isPointInRange and calculateForce; "tree" is
+// computeGravityForces, which only evaluates fields whose bounds overlap
+// each object. "step" is a whole fixed tick with the same fields.
+int main() {
+    const float worldSize = 2400.0f;
+    const int objectCount = 500;
+
+    std::printf("%d objects, us per evaluation of every object\n", objectCount);
+    std::printf("%-7s %10s %10s %8s %10s\n", "fields", "brute", "tree", "speedup", "step");
+
+    for (int fieldCount : {1, 10, 50, 200, 1000}) {
+        PhysicsWorld world;
+        world.initialize();
+        world.setStepBudget(PHYSICS_MAX_SUBSTEPS, 0.0f);
+        world.createBoundaries(worldSize, worldSize);
+
+        // Same scatter for every field count so only the fields change
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> spread(60.0f, worldSize - 60.0f);
+        std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+        for (int i = 0; i < objectCount; ++i) {
+            world.createObject(ObjectType::Ball, Vec2(spread(rng), spread(rng)), 0.6f);
+        }
+        for (int i = 0; i < fieldCount; ++i) {
+            float a = angle(rng);
+            world.createGravityField(Vec2(spread(rng), spread(rng)), Vec2(std::cos(a), std::sin(a)),
+                                     MAX_GRAVITY_STRENGTH, GRAVITY_STROKE_RADIUS);
+        }
+
+        std::vector<float> posX, posY;
+        for (const PhysicsObject& object : world.getObjects()) {
+            Vec2 position = object.getPosition();
+            posX.push_back(position.x);
+            posY.push_back(position.y);
+        }
+        const size_t count = posX.size();
+        std::vector<float> forceX(count), forceY(count);
+        const SlotMap<GravityField>& fields = world.getGravityFields();
+
+        int iterations = fieldCount >= 200 ? 20 : 200;
+        double bruteTime = timeBest([&]() {
+            for (size_t i = 0; i < count; ++i) {
+                Vec2 position(posX[i], posY[i]);
+                Vec2 total;
+                for (const GravityField& field : fields) {
+                    if (field.isActive() && field.isPointInRange(position)) {
+                        total += field.calculateForce(position);
+                    }
+                }
+                forceX[i] = total.x;
+                forceY[i] = total.y;
+            }
+            g_benchSink = forceX[count / 2];
+        }, iterations);
+
+        double treeTime = timeBest([&]() {
+            world.computeGravityForces(posX.data(), posY.data(), forceX.data(), forceY.data(), count);
+            g_benchSink = forceX[count / 2];
+        }, iterations);
+
+        const float timestep = world.getTimestep();
+        double stepTime = timeBest([&]() {
+            world.update(timestep);
+        }, 60, 3);
+
+        std::printf("%-7d %10.1f %10.1f %7.1fx %10.1f\n", fieldCount, bruteTime * 1e6, treeTime * 1e6,
+                    bruteTime / treeTime, stepTime * 1e6);
+    }
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include "GravityPaint/core/SimulationThread.h"
+#include "GravityPaint/sim/LevelSimulation.h"
+#include "GravityPaint/sim/SimulationBatch.h"
+#include "GravityPaint/physics/PhysicsWorld.h"
+#include "GravityPaint/physics/PhysicsObject.h"
+#include "GravityPaint/level/LevelManager.h"
+#include "BenchTimer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace GravityPaint;
+
+namespace {
+
+constexpr int LEVEL_ID = 20;
+constexpr int EXTRA_BALLS = 1500;
+constexpr int FRAMES = 600;
+
+// A level with 1500 extra balls under three screen-wide strokes
+bool buildStressScene(LevelManager& levels, PhysicsWorld& physics, LevelSimulation& simulation) {
+    levels.setRandomSeed(1234);
+    levels.initialize(DEFAULT_SCREEN_WIDTH, DEFAULT_SCREEN_HEIGHT);
+    if (!levels.loadLevel(LEVEL_ID) || !physics.initialize()) return false;
+    if (!simulation.setupLevel(GravityMode::Fields, 0.0f)) return false;
+
+    float width = static_cast<float>(DEFAULT_SCREEN_WIDTH);
+    float height = static_cast<float>(DEFAULT_SCREEN_HEIGHT);
+    const int perRow = static_cast<int>((width - 60.0f) / 30.0f);
+    for (int i = 0; i < EXTRA_BALLS; ++i) {
+        physics.createObject(ObjectType::Ball,
+                             Vec2(45.0f + 30.0f * static_cast<float>(i % perRow),
+                                  200.0f + 30.0f * static_cast<float>(i / perRow)),
+                             0.6f);
+    }
+
+    const Vec2 corners[][2] = {
+        {Vec2(0.0f, 0.0f), Vec2(width, height)},
+        {Vec2(width, 0.0f), Vec2(0.0f, height)},
+        {Vec2(0.0f, height), Vec2(width, 0.0f)},
+    };
+    for (const auto& corner : corners) {
+        GravityStroke stroke = SimulationBatch::makeSwipe(corner[0], corner[1], 16);
+        stroke.maxLifetime = 1000.0f;
+        simulation.commitStroke(stroke);
+    }
+    return true;
+}
+
+// Stands in for drawing: touches every object the renderer would
+float consumeObjects(const std::vector<ObjectSnapshot>& objects) {
+    float sum = 0.0f;
+    for (const auto& object : objects) {
+        sum += object.position.x + object.position.y;
+    }
+    return sum;
+}
+
+void report(const char* name, std::vector<double>& frameMs) {
+    std::sort(frameMs.begin(), frameMs.end());
+    double total = 0.0;
+    for (double ms : frameMs) {
+        total += ms;
+    }
+    std::printf("%-9s %9.3f %9.3f %9.3f %9.3f\n", name, total / frameMs.size(),
+                frameMs[frameMs.size() / 2], frameMs[frameMs.size() * 99 / 100], frameMs.back());
+}
+
+} // namespace
+
+// Main-thread frame time in a stress scene, stepping physics inline as
+// Game::runOneFrame used to against handing it to SimulationThread and
+// reading its published snapshots. Both read every object once per frame
+// in place of rendering; the threaded run is paced at TARGET_FRAME_TIME.
+int main() {
+    using Clock = std::chrono::steady_clock;
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<float>(TARGET_FRAME_TIME));
+
+    std::printf("%d extra balls on level %d, %d frames, main-thread ms per frame\n",
+                EXTRA_BALLS, LEVEL_ID, FRAMES);
+    std::printf("%-9s %9s %9s %9s %9s\n", "mode", "mean", "median", "p99", "max");
+
+    std::vector<double> frameMs;
+    frameMs.reserve(FRAMES);
+
+    {
+        LevelManager levels;
+        PhysicsWorld physics;
+        LevelSimulation simulation(&physics, &levels);
+        if (!buildStressScene(levels, physics, simulation)) {
+            std::fprintf(stderr, "stress scene setup failed\n");
+            return 1;
+        }
+
+        std::vector<ObjectSnapshot> objects;
+        for (int frame = 0; frame < FRAMES; ++frame) {
+            auto start = Clock::now();
+            simulation.update(TARGET_FRAME_TIME);
+            float alpha = physics.getInterpolationAlpha();
+            objects.resize(physics.getObjects().size());
+            for (size_t i = 0; i < objects.size(); ++i) {
+                physics.getObjects()[i].fillSnapshot(objects[i], alpha);
+            }
+            g_benchSink = consumeObjects(objects);
+            frameMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+        report("inline", frameMs);
+    }
+
+    frameMs.clear();
+    {
+        LevelManager levels;
+        PhysicsWorld physics;
+        SimulationThread simulation(&physics, &levels);
+        if (!buildStressScene(levels, physics, simulation.getLevelSimulation())) {
+            std::fprintf(stderr, "stress scene setup failed\n");
+            return 1;
+        }
+
+        simulation.start();
+        uint64_t firstStep = simulation.acquireSnapshot().step;
+        auto next = Clock::now();
+        for (int frame = 0; frame < FRAMES; ++frame) {
+            auto start = Clock::now();
+            simulation.update(TARGET_FRAME_TIME);
+            g_benchSink = consumeObjects(simulation.acquireSnapshot().objects);
+            frameMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+
+            next += period;
+            std::this_thread::sleep_until(next);
+        }
+        uint64_t steps = simulation.acquireSnapshot().step - firstStep;
+        simulation.stop();
+        report("threaded", frameMs);
+        std::printf("simulation thread published %llu steps over %d frames\n",
+                    static_cast<unsigned long long>(steps), FRAMES);
+    }
+    return 0;
+}
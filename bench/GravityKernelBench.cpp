@@ -0,0 +1,59 @@
+#include "GravityPaint/physics/GravityKernel.h"
+#include "GravityPaint/physics/GravityField.h"
+#include "BenchTimer.h"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace GravityPaint;
+
+// accumulateFieldForces against the per-object GravityField::calculateForce
+// loop it replaced, for each zone type over a batch of positions spread
+// around the field (about half of them in range)
+int main() {
+    const size_t count = 1024;
+    const int iterations = 2000;
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> spread(-170.0f, 170.0f);
+    std::vector<float> posX(count), posY(count), forceX(count), forceY(count);
+    for (size_t i = 0; i < count; ++i) {
+        posX[i] = 500.0f + spread(rng);
+        posY[i] = 500.0f + spread(rng);
+    }
+
+    const struct {
+        ZoneType zone;
+        const char* name;
+    } zones[] = {
+        {ZoneType::Normal, "Normal"}, {ZoneType::Boost, "Boost"}, {ZoneType::Slow, "Slow"},
+        {ZoneType::Reverse, "Reverse"}, {ZoneType::Attract, "Attract"}, {ZoneType::Repel, "Repel"},
+        {ZoneType::Zero, "Zero"},
+    };
+
+    std::printf("%zu positions per call\n", count);
+    std::printf("%-8s %12s %12s %8s\n", "zone", "scalar ns", "kernel ns", "speedup");
+
+    for (const auto& entry : zones) {
+        GravityField field(Vec2(500.0f, 500.0f), Vec2(0.6f, 0.8f), 250.0f, 150.0f);
+        field.setZoneType(entry.zone);
+
+        double scalar = timeBest([&]() {
+            for (size_t i = 0; i < count; ++i) {
+                Vec2 force = field.calculateForce(Vec2(posX[i], posY[i]));
+                forceX[i] += force.x;
+                forceY[i] += force.y;
+            }
+            g_benchSink = forceX[count / 2];
+        }, iterations);
+
+        double kernel = timeBest([&]() {
+            accumulateFieldForces(field, posX.data(), posY.data(), forceX.data(), forceY.data(), count);
+            g_benchSink = forceX[count / 2];
+        }, iterations);
+
+        std::printf("%-8s %12.1f %12.1f %7.2fx\n", entry.name,
+                    scalar * 1e9 / count, kernel * 1e9 / count, scalar / kernel);
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include "GravityPaint/physics/GravityKernel.h"
+#include "GravityPaint/physics/GravityField.h"
+#include "GravityPaint/Constants.h"
+#include "BenchTimer.h"
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace GravityPaint;
+
+// Cost per object of a stroke's field for 5, 50 and 500-point strokes:
+// the old single radial field at the stroke midpoint, the polyline field
+// through its BVH one object at a time, and the polyline field through
+// accumulateFieldForces as PhysicsWorld calls it
+int main() {
+    const size_t count = 256;
+    const int iterations = 2000;
+
+    // Objects scattered over a band around the stroke, most within reach
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> spreadX(150.0f, 950.0f);
+    std::uniform_real_distribution<float> spreadY(300.0f, 700.0f);
+    std::vector<float> posX(count), posY(count), forceX(count), forceY(count);
+    for (size_t i = 0; i < count; ++i) {
+        posX[i] = spreadX(rng);
+        posY[i] = spreadY(rng);
+    }
+
+    std::printf("%zu objects per call, ns per object\n", count);
+    std::printf("%-7s %10s %10s %10s\n", "points", "midpoint", "bvh", "kernel");
+
+    for (size_t pointCount : {5, 50, 500}) {
+        std::vector<Vec2> points(pointCount);
+        for (size_t i = 0; i < pointCount; ++i) {
+            float x = 250.0f + 600.0f * static_cast<float>(i) / static_cast<float>(pointCount - 1);
+            points[i] = Vec2(x, 500.0f + 80.0f * std::sin(x * 0.01f));
+        }
+        Vec2 direction(1.0f, 0.0f);
+
+        GravityField midpoint(points[pointCount / 2], direction, MAX_GRAVITY_STRENGTH, GRAVITY_STROKE_RADIUS);
+        GravityField path(points[pointCount / 2], direction, MAX_GRAVITY_STRENGTH, GRAVITY_STROKE_RADIUS);
+        path.setPath(points);
+
+        double pointTime = timeBest([&]() {
+            accumulateFieldForces(midpoint, posX.data(), posY.data(), forceX.data(), forceY.data(), count);
+            g_benchSink = forceX[count / 2];
+        }, iterations);
+
+        double bvhTime = timeBest([&]() {
+            for (size_t i = 0; i < count; ++i) {
+                Vec2 force = path.calculateForce(Vec2(posX[i], posY[i]));
+                forceX[i] += force.x;
+                forceY[i] += force.y;
+            }
+            g_benchSink = forceX[count / 2];
+        }, iterations);
+
+        double kernelTime = timeBest([&]() {
+            accumulateFieldForces(path, posX.data(), posY.data(), forceX.data(), forceY.data(), count);
+            g_benchSink = forceX[count / 2];
+        }, iterations);
+
+        std::printf("%-7zu %10.1f %10.1f %10.1f\n", pointCount,
+                    pointTime * 1e9 / count, bvhTime * 1e9 / count, kernelTime * 1e9 / count);
+    }
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include "GravityPaint/sim/SimulationBatch.h"
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace GravityPaint;
+
+// World-ticks per second of SimulationBatch at 1, 2, 4, ... threads up to
+// the hardware count. Every run is the same set of jobs: the first 50
+// campaign levels, each with two scripted swipes and cut to 20 seconds, so
+// the results also have to agree across thread counts.
+int main() {
+    const int jobCount = 64;
+    const float width = static_cast<float>(DEFAULT_SCREEN_WIDTH);
+    const float height = static_cast<float>(DEFAULT_SCREEN_HEIGHT);
+
+    std::vector<SimulationJob> jobs;
+    for (int i = 0; i < jobCount; ++i) {
+        SimulationJob job;
+        job.levelId = 1 + i % 50;
+        job.maxTime = 20.0f;
+
+        ScriptedStroke first;
+        first.stroke = SimulationBatch::makeSwipe(Vec2(width * 0.2f, height * 0.3f),
+                                                  Vec2(width * 0.8f, height * 0.4f));
+        ScriptedStroke second;
+        second.time = 2.0f + 0.25f * static_cast<float>(i % 8);
+        second.stroke = SimulationBatch::makeSwipe(Vec2(width * 0.7f, height * 0.6f),
+                                                   Vec2(width * 0.3f, height * 0.8f));
+        job.strokes = {first, second};
+        jobs.push_back(job);
+    }
+
+    int hardware = static_cast<int>(std::thread::hardware_concurrency());
+    if (hardware < 1) hardware = 1;
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < hardware; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(hardware);
+
+    std::printf("%d jobs, %d hardware threads\n", jobCount, hardware);
+    std::printf("%-8s %12s %10s %16s %8s\n", "threads", "world-ticks", "seconds", "world-ticks/s", "scaling");
+
+    double baseline = 0.0;
+    std::vector<SimulationResult> reference;
+    for (int threads : threadCounts) {
+        SimulationBatch batch(threads);
+        for (const SimulationJob& job : jobs) {
+            batch.addJob(job);
+        }
+        batch.run();
+
+        const SimulationBatchStats& stats = batch.getStats();
+        if (baseline == 0.0) {
+            baseline = stats.worldTicksPerSecond;
+            reference = batch.getResults();
+        }
+
+        // Each world is independent, so the thread count must not change results
+        const std::vector<SimulationResult>& results = batch.getResults();
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (results[i].stateHash != reference[i].stateHash) {
+                std::fprintf(stderr, "job %zu diverged at %d threads\n", i, threads);
+            }
+        }
+
+        std::printf("%-8d %12llu %10.3f %16.0f %7.2fx\n", stats.threadCount,
+                    static_cast<unsigned long long>(stats.totalTicks), stats.wallSeconds,
+                    stats.worldTicksPerSecond, stats.worldTicksPerSecond / baseline);
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include "GravityPaint/physics/PhysicsWorld.h"
+#include "GravityPaint/Constants.h"
+#include "BenchTimer.h"
+#include <cstdio>
+#include <vector>
+
+using namespace GravityPaint;
+
+namespace {
+
+const float WORLD_SIZE = 2400.0f;
+
+// One stroke-sized field over the middle of the world
+void spawnField(PhysicsWorld& world) {
+    world.createGravityField(Vec2(WORLD_SIZE * 0.5f, WORLD_SIZE * 0.5f), Vec2(1.0f, 0.0f),
+                             MAX_GRAVITY_STRENGTH, GRAVITY_STROKE_RADIUS);
+}
+
+// Grid of mixed objects, 30 px apart; size 0.6 keeps them from overlapping
+void spawnObjects(PhysicsWorld& world, int count, std::vector<Vec2>& positions) {
+    positions.clear();
+    const int perRow = 70;
+    for (int i = 0; i < count; ++i) {
+        Vec2 position(60.0f + 30.0f * static_cast<float>(i % perRow),
+                      60.0f + 30.0f * static_cast<float>(i / perRow));
+        world.createObject(static_cast<ObjectType>(i % OBJECT_TYPE_COUNT), position, 0.6f);
+        positions.push_back(position);
+    }
+}
+
+} // namespace
+
+// Level restart cost per 100 bodies: captureSnapshot once at level start,
+// then restoreSnapshot on every restart, against the old path of reset()
+// and a full respawn. Objects have been simulated for a second before each
+// restart so the restore has real state to write back.
+int main() {
+    const int iterations = 20;
+
+    std::printf("ms per 100 bodies\n");
+    std::printf("%-7s %10s %10s %10s %8s\n", "bodies", "capture", "restore", "respawn", "speedup");
+
+    for (int count : {100, 250, 500, 1000}) {
+        PhysicsWorld world;
+        world.initialize();
+        world.setStepBudget(PHYSICS_MAX_SUBSTEPS, 0.0f);
+        world.createBoundaries(WORLD_SIZE, WORLD_SIZE);
+        spawnField(world);
+
+        std::vector<Vec2> positions;
+        spawnObjects(world, count, positions);
+
+        WorldSnapshot snapshot;
+        double captureTime = timeBest([&]() {
+            world.captureSnapshot(snapshot);
+        }, iterations);
+
+        // Disturb the world outside the timed region, then time the restart
+        auto simulate = [&]() {
+            for (int tick = 0; tick < 60; ++tick) {
+                world.update(world.getTimestep());
+            }
+        };
+
+        double restoreTime = 1e30;
+        double respawnTime = 1e30;
+        for (int i = 0; i < iterations; ++i) {
+            simulate();
+            restoreTime = std::min(restoreTime, timeBest([&]() {
+                if (!world.restoreSnapshot(snapshot)) {
+                    std::fprintf(stderr, "restoreSnapshot failed at %d bodies\n", count);
+                }
+            }, 1, 1));
+
+            simulate();
+            respawnTime = std::min(respawnTime, timeBest([&]() {
+                world.reset();
+                spawnField(world);
+                for (size_t j = 0; j < positions.size(); ++j) {
+                    world.createObject(static_cast<ObjectType>(j % OBJECT_TYPE_COUNT), positions[j], 0.6f);
+                }
+            }, 1, 1));
+
+            // Respawned objects and fields have new handles; capture afresh
+            world.captureSnapshot(snapshot);
+        }
+        g_benchSink = static_cast<float>(world.computeStateHash());
+
+        double per100 = 100.0 / count;
+        std::printf("%-7d %10.4f %10.4f %10.4f %7.1fx\n", count,
+                    captureTime * 1e3 * per100, restoreTime * 1e3 * per100,
+                    respawnTime * 1e3 * per100, respawnTime / restoreTime);
+    }
+    return 0;
+}
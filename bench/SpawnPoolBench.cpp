@@ -0,0 +1,109 @@
+#include "GravityPaint/sim/LevelSimulation.h"
+#include "GravityPaint/physics/PhysicsWorld.h"
+#include "GravityPaint/level/LevelManager.h"
+#include "GravityPaint/Constants.h"
+#include <algorithm>
+#include <cstdio>
+
+using namespace GravityPaint;
+
+namespace {
+
+const char* const TYPE_NAMES[OBJECT_TYPE_COUNT] = {"ball", "box", "triangle", "star", "blob"};
+
+// Spawns count objects of one type on a 30 px grid
+void spawnGrid(PhysicsWorld& world, ObjectType type, int count, float size) {
+    const int perRow = 70;
+    for (int i = 0; i < count; ++i) {
+        world.createObject(type, Vec2(45.0f + 30.0f * static_cast<float>(i % perRow),
+                                      45.0f + 30.0f * static_cast<float>(i / perRow)), size);
+    }
+}
+
+// Mean spawn cost in microseconds between two readings of the stats
+double builtMicros(const PhysicsPoolStats& before, const PhysicsPoolStats& after) {
+    uint64_t spawns = after.builtSpawns - before.builtSpawns;
+    return spawns ? (after.builtSeconds - before.builtSeconds) * 1e6 / spawns : 0.0;
+}
+
+double pooledMicros(const PhysicsPoolStats& before, const PhysicsPoolStats& after) {
+    uint64_t spawns = after.pooledSpawns - before.pooledSpawns;
+    return spawns ? (after.pooledSeconds - before.pooledSeconds) * 1e6 / spawns : 0.0;
+}
+
+} // namespace
+
+// Spawn cost as PhysicsPoolStats records it: bodies built new against
+// bodies taken back from the pool, at the size they were built for and
+// at another size (which rebuilds the fixture). Each round spawns 1,000
+// objects, and reset() returns them all to the pool for the next round;
+// each figure is the best of five fresh worlds. The last table is a
+// campaign level loaded through LevelSimulation and played until its
+// delayed spawns are in, which is where the prewarmed pool pays off.
+int main() {
+    const int count = 1000;
+    const int rounds = 5;
+
+    std::printf("%d spawns per round, us per spawn\n", count);
+    std::printf("%-9s %9s %9s %9s %9s\n", "type", "built", "pooled", "resized", "speedup");
+
+    for (int t = 0; t < OBJECT_TYPE_COUNT; ++t) {
+        ObjectType type = static_cast<ObjectType>(t);
+        double built = 1e9, pooled = 1e9, resized = 1e9;
+        uint64_t rebuilds = 0;
+
+        for (int round = 0; round < rounds; ++round) {
+            PhysicsWorld world;
+            world.initialize();
+            world.createBoundaries(2400.0f, 2400.0f);
+
+            PhysicsPoolStats start = world.getPoolStats();
+            spawnGrid(world, type, count, 0.6f);
+            PhysicsPoolStats afterBuilt = world.getPoolStats();
+            world.reset();
+
+            spawnGrid(world, type, count, 0.6f);
+            PhysicsPoolStats afterPooled = world.getPoolStats();
+            world.reset();
+
+            spawnGrid(world, type, count, 0.8f);
+            PhysicsPoolStats afterResized = world.getPoolStats();
+
+            built = std::min(built, builtMicros(start, afterBuilt));
+            pooled = std::min(pooled, pooledMicros(afterBuilt, afterPooled));
+            resized = std::min(resized, pooledMicros(afterPooled, afterResized));
+            rebuilds = afterResized.fixtureRebuilds - afterPooled.fixtureRebuilds;
+        }
+
+        std::printf("%-9s %9.3f %9.3f %9.3f %8.1fx\n", TYPE_NAMES[t], built, pooled, resized, built / pooled);
+        if (rebuilds != static_cast<uint64_t>(count)) {
+            std::fprintf(stderr, "%s: %llu fixture rebuilds, expected %d\n", TYPE_NAMES[t],
+                         static_cast<unsigned long long>(rebuilds), count);
+        }
+    }
+
+    std::printf("\nlevel load and play, us per spawn\n");
+    std::printf("%-7s %8s %9s %8s %9s\n", "level", "built", "us", "pooled", "us");
+    for (int levelId : {5, 20, 40}) {
+        LevelManager levels;
+        levels.setRandomSeed(1234);
+        levels.initialize(DEFAULT_SCREEN_WIDTH, DEFAULT_SCREEN_HEIGHT);
+        PhysicsWorld physics;
+        LevelSimulation simulation(&physics, &levels);
+        if (!levels.loadLevel(levelId) || !simulation.setupLevel(GravityMode::Fields, 0.0f)) {
+            std::fprintf(stderr, "level %d setup failed\n", levelId);
+            continue;
+        }
+
+        // A fresh PhysicsWorld per level, so the stats cover this level only
+        for (int tick = 0; tick < PHYSICS_TICK_RATE * 30; ++tick) {
+            simulation.update(physics.getTimestep());
+        }
+        const PhysicsPoolStats& stats = physics.getPoolStats();
+        PhysicsPoolStats none;
+        std::printf("%-7d %8llu %9.3f %8llu %9.3f\n", levelId,
+                    static_cast<unsigned long long>(stats.builtSpawns), builtMicros(none, stats),
+                    static_cast<unsigned long long>(stats.pooledSpawns), pooledMicros(none, stats));
+    }
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include "GravityPaint/physics/PhysicsWorld.h"
+#include "GravityPaint/physics/PhysicsObject.h"
+#include "GravityPaint/Constants.h"
+#include "BenchTimer.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace GravityPaint;
+
+namespace {
+
+// A long session with physics LOD on or off: 2,000 balls fall into a
+// settled pile under the stroke field, a weak field across the whole
+// world (too weak to wake a sleeping body) and a goal across half the floor.
+// Prints the b2Profile collide and solve times per tick, averaged over
+// the whole run, and what the LOD skipped.
+void runLongSession(bool lod) {
+    const float worldSize = 2400.0f;
+    const int count = 2000;
+    const int ticks = PHYSICS_TICK_RATE * 60;
+
+    PhysicsWorld world;
+    world.initialize();
+    world.setStepBudget(PHYSICS_MAX_SUBSTEPS, 0.0f);
+    world.setLodEnabled(lod);
+    world.createBoundaries(worldSize, worldSize);
+    world.createGravityField(Vec2(worldSize * 0.5f, worldSize * 0.5f), Vec2(0.0f, -1.0f),
+                             MAX_GRAVITY_STRENGTH, GRAVITY_STROKE_RADIUS);
+    world.createGravityField(Vec2(worldSize * 0.5f, worldSize), Vec2(1.0f, 0.0f),
+                             PHYSICS_WAKE_ACCELERATION * 0.5f, worldSize * 2.0f);
+    world.createGoalZone(Vec2(worldSize * 0.25f, worldSize - 100.0f), Vec2(worldSize * 0.5f, 200.0f));
+
+    const int perRow = static_cast<int>((worldSize - 60.0f) / 30.0f);
+    for (int i = 0; i < count; ++i) {
+        world.createObject(ObjectType::Ball,
+                           Vec2(45.0f + 30.0f * static_cast<float>(i % perRow),
+                                45.0f + 30.0f * static_cast<float>(i / perRow)),
+                           0.6f);
+    }
+
+    world.resetStepStats();
+    const float timestep = world.getTimestep();
+    auto start = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks; ++tick) {
+        world.update(timestep);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const PhysicsStepStats& stats = world.getStepStats();
+    const double perTick = stats.ticks ? 1.0 / static_cast<double>(stats.ticks) : 0.0;
+    std::printf("%-7s %9.3f %9.3f %9.3f %10llu %10llu %7llu\n", lod ? "on" : "off",
+                seconds * 1e3 * perTick, stats.collideMs * perTick, stats.solveMs * perTick,
+                static_cast<unsigned long long>(stats.sleepingSkips),
+                static_cast<unsigned long long>(stats.reducedRateSkips),
+                static_cast<unsigned long long>(stats.frozenObjects));
+}
+
+} // namespace
+
+// Step and query cost as the body count grows to 5,000. Small balls sit on
+// a 30 px grid in a bounded 2400x2400 world under one stroke field; each
+// count is warmed up for a second before timing. Queries are timed per
+// query. Point lookups compare getObjectAtPoint per point with one
+// getObjectsAtPoints call, for points spread over the world and for
+// points within a 300 px square (a stroke's worth). The last table is a minute-long session
+// with physics LOD on and off.
+int main() {
+    const float worldSize = 2400.0f;
+    const size_t queryCount = 256;
+    const int stepTicks = 120;
+
+    std::mt19937 rng(19);
+    std::uniform_real_distribution<float> spread(40.0f, worldSize - 40.0f);
+    std::uniform_real_distribution<float> cluster(1000.0f, 1300.0f);
+    std::vector<Vec2> points(queryCount), nearPoints(queryCount), rayFrom(queryCount), rayTo(queryCount);
+    for (size_t i = 0; i < queryCount; ++i) {
+        points[i] = Vec2(spread(rng), spread(rng));
+        nearPoints[i] = Vec2(cluster(rng), cluster(rng));
+        rayFrom[i] = Vec2(spread(rng), spread(rng));
+        rayTo[i] = Vec2(spread(rng), spread(rng));
+    }
+    std::vector<PhysicsObject*> results(queryCount);
+    std::vector<RayHit> hits(queryCount);
+    std::vector<PhysicsObject*> areaResults(1024);
+
+    std::printf("step: ms per tick; queries: us per query\n");
+    std::printf("%-7s %9s %9s %9s %9s %9s %9s %9s\n", "bodies", "step",
+                "point", "points", "near", "nears", "area", "ray");
+
+    for (int count : {100, 500, 1000, 2000, 5000}) {
+        PhysicsWorld world;
+        world.initialize();
+        world.setStepBudget(PHYSICS_MAX_SUBSTEPS, 0.0f);
+        world.createBoundaries(worldSize, worldSize);
+        world.createGravityField(Vec2(worldSize * 0.5f, worldSize * 0.5f), Vec2(0.0f, -1.0f),
+                                 MAX_GRAVITY_STRENGTH, GRAVITY_STROKE_RADIUS);
+
+        const int perRow = static_cast<int>((worldSize - 60.0f) / 30.0f);
+        for (int i = 0; i < count; ++i) {
+            world.createObject(ObjectType::Ball,
+                               Vec2(45.0f + 30.0f * static_cast<float>(i % perRow),
+                                    45.0f + 30.0f * static_cast<float>(i / perRow)),
+                               0.6f);
+        }
+
+        const float timestep = world.getTimestep();
+        for (int tick = 0; tick < 60; ++tick) {
+            world.update(timestep);
+        }
+
+        double stepTime = timeBest([&]() {
+            world.update(timestep);
+        }, stepTicks, 3);
+
+        double pointTime = timeBest([&]() {
+            for (size_t i = 0; i < queryCount; ++i) {
+                results[i] = world.getObjectAtPoint(points[i]);
+            }
+            g_benchSink = results[0] ? 1.0f : 0.0f;
+        }, 20);
+
+        double pointsTime = timeBest([&]() {
+            world.getObjectsAtPoints(points.data(), queryCount, results.data());
+            g_benchSink = results[0] ? 1.0f : 0.0f;
+        }, 20);
+
+        double nearTime = timeBest([&]() {
+            for (size_t i = 0; i < queryCount; ++i) {
+                results[i] = world.getObjectAtPoint(nearPoints[i]);
+            }
+            g_benchSink = results[0] ? 1.0f : 0.0f;
+        }, 20);
+
+        double nearsTime = timeBest([&]() {
+            world.getObjectsAtPoints(nearPoints.data(), queryCount, results.data());
+            g_benchSink = results[0] ? 1.0f : 0.0f;
+        }, 20);
+
+        double areaTime = timeBest([&]() {
+            size_t found = 0;
+            for (size_t i = 0; i < queryCount; ++i) {
+                Rect area(points[i].x - 100.0f, points[i].y - 100.0f, 200.0f, 200.0f);
+                found += world.getObjectsInArea(area, areaResults.data(), areaResults.size());
+            }
+            g_benchSink = static_cast<float>(found);
+        }, 20);
+
+        double rayTime = timeBest([&]() {
+            for (size_t i = 0; i < queryCount; ++i) {
+                world.rayCast(rayFrom[i], rayTo[i], hits[i]);
+            }
+            g_benchSink = hits[0].fraction;
+        }, 20);
+
+        const double perQuery = 1e6 / queryCount;
+        std::printf("%-7d %9.3f %9.3f %9.3f %9.3f %9.3f %9.3f %9.3f\n", count, stepTime * 1e3,
+                    pointTime * perQuery, pointsTime * perQuery, nearTime * perQuery,
+                    nearsTime * perQuery, areaTime * perQuery, rayTime * perQuery);
+    }
+
+    std::printf("\n2000 bodies for 60 s, ms per tick\n");
+    std::printf("%-7s %9s %9s %9s %10s %10s %7s\n", "lod", "step", "collide", "solve",
+                "sleeping", "reduced", "frozen");
+    runLongSession(true);
+    runLongSession(false);
+    return 0;
+}
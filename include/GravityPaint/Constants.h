@@ -17,11 +17,32 @@ constexpr float GRAVITY_STROKE_LIFETIME = 2.0f;
 constexpr float GRAVITY_STROKE_RADIUS = 150.0f;
 constexpr int PHYSICS_VELOCITY_ITERATIONS = 8;
 constexpr int PHYSICS_POSITION_ITERATIONS = 3;
+constexpr int PHYSICS_TICK_RATE = 60;  // Default; PhysicsWorld::setTickRate takes 30/60/120/240
+constexpr float MAX_FRAME_DELTA = 0.1f;         // Longer frames are clamped (time dropped)
+constexpr int PHYSICS_MAX_SUBSTEPS = 8;         // Ticks per update before the backlog is dilated
+constexpr float PHYSICS_STEP_BUDGET = 0.008f;   // Wall-clock seconds per update, 0 = unlimited
+constexpr int CONTACT_EVENT_CAPACITY = 256;     // Minimum contact pairs per tick; grows with the contact count
+constexpr float CONTACT_IMPULSE_THRESHOLD = 1.0f; // Below this a contact transfers no energy
+constexpr float PHYSICS_WAKE_ACCELERATION = 1.0f; // Weaker field pulls leave sleeping bodies asleep
+constexpr int PHYSICS_LOD_INTERVAL = 4;         // Ticks between field evaluations for idle objects
+constexpr float PHYSICS_LOD_MARGIN = 200.0f;    // Pixels beyond the world edge that count as far off-screen
+constexpr int SURFACE_SPRING_SUBSTEPS = 4;      // Explicit surface solver substeps per update
+constexpr int SURFACE_XPBD_ITERATIONS = 4;      // Default constraint iterations for XPBD surfaces
+constexpr float SURFACE_SLEEP_ENERGY = 0.05f;   // Per-node kinetic energy below which a surface may sleep
+constexpr float SURFACE_SLEEP_DISTANCE = 0.1f;  // Pixels from rest below which a node counts as settled
+constexpr float SURFACE_SLEEP_TIME = 0.5f;      // Seconds a surface must stay settled before it sleeps
+constexpr int SURFACE_WAKE_MARGIN = 2;          // Node columns simulated beyond an impact's reach
 
 // Gameplay
 constexpr float MIN_SWIPE_DISTANCE = 15.0f;   // Reduced for better sensitivity
 constexpr float MAX_SWIPE_DISTANCE = 300.0f;  // Reach max strength faster
 constexpr int MAX_ACTIVE_STROKES = 5;
+constexpr int MAX_PAINT_STROKES = 64;          // Visual cap only; paint cost doesn't grow per stroke
+constexpr float PAINT_GRID_CELL_SIZE = 40.0f;
+constexpr float PAINT_FIELD_DECAY_RATE = 1.5f;  // Per second, exponential
+constexpr float PAINT_FIELD_EPSILON = 0.1f;     // Decayed grids below this magnitude everywhere count as empty
+constexpr float PAINT_FIELD_DIFFUSION_RATE = 2.0f;
+constexpr float ZONE_GRID_CELL_SIZE = 20.0f;     // Resolution of baked level gravity zones
 constexpr float ENERGY_TRANSFER_RATE = 0.7f;
 constexpr float ENERGY_DECAY_RATE = 0.1f;
 constexpr float MAX_OBJECT_ENERGY = 100.0f;
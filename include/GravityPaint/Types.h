@@ -119,6 +119,23 @@ struct TouchPoint {
     float timestamp = 0.0f;
 };
 
+// Stable reference into a SlotMap. The generation changes whenever the slot
+// is reused, so a handle to a removed element resolves to nullptr instead
+// of whatever took its place. Default-constructed handles are never valid.
+struct SlotHandle {
+    uint32_t index = 0;
+    uint32_t generation = 0;
+
+    bool operator==(const SlotHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+};
+
+using ObjectHandle = SlotHandle;
+using FieldHandle = SlotHandle;
+using SurfaceHandle = SlotHandle;
+
 // Gravity vector with decay
 struct GravityStroke {
     std::vector<Vec2> points;
@@ -128,6 +145,7 @@ struct GravityStroke {
     float maxLifetime = 2.0f;
     Color color;
     bool isActive = true;
+    FieldHandle field;  // Owned by PhysicsWorld, see bindStrokeField()
 
     float getAlpha() const {
         return std::max(0.0f, 1.0f - (lifetime / maxLifetime));
@@ -142,6 +160,7 @@ enum class ObjectType {
     Star,
     Blob
 };
+constexpr int OBJECT_TYPE_COUNT = 5;
 
 // Zone types for gravity influence
 enum class ZoneType {
@@ -154,6 +173,18 @@ enum class ZoneType {
     Zero
 };
 
+// How gravity strokes act on objects
+enum class GravityMode {
+    Fields,  // Each stroke binds its own GravityField
+    Paint    // Strokes are painted into a decaying vector-field grid
+};
+
+// How a DeformableSurface integrates its springs
+enum class SurfaceSolver {
+    Springs,  // Explicit forces over several substeps; diverges when stiff
+    XPBD      // Compliant position constraints, one step per update
+};
+
 // Game states
 enum class GameStateType {
     Menu,
@@ -194,7 +225,6 @@ enum class ObjectiveType {
 
 // Callback types
 using UpdateCallback = std::function<void(float deltaTime)>;
-using CollisionCallback = std::function<void(class PhysicsObject*, class PhysicsObject*)>;
 using InputCallback = std::function<void(const TouchPoint&)>;
 
 // Simple particle for inline effects (different from ParticleSystem's Particle)
@@ -212,4 +242,32 @@ struct SimpleParticle {
     float alpha() const { return life / maxLife; }
 };
 
+// Copy of a PhysicsObject's drawable state, safe to read off the physics thread
+struct ObjectSnapshot {
+    int id = 0;
+    ObjectType type = ObjectType::Ball;
+    Vec2 position;
+    float angle = 0.0f;
+    float size = 1.0f;
+    float energy = 0.0f;
+    Color color;
+    Color energyColor;
+    bool active = true;
+    bool reachedGoal = false;
+    std::vector<Vec2> trail;
+};
+
+// One contact between two objects, merged per pair per physics tick.
+// idA < idB; began is set when the pair started touching this tick.
+struct ContactEvent {
+    int idA = 0;
+    int idB = 0;
+    Vec2 point;                 // Pixels
+    float normalImpulse = 0.0f; // Largest solver impulse seen this tick
+    bool began = false;
+    uint64_t tick = 0;
+};
+
+using ContactCallback = std::function<void(const std::vector<ContactEvent>& contacts)>;
+
 } // namespace GravityPaint
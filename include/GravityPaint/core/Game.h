@@ -3,6 +3,7 @@
 #include "GravityPaint/Types.h"
 #include "GravityPaint/Constants.h"
 #include <memory>
+#include <string>
 #include <SDL.h>
 
 namespace GravityPaint {
@@ -79,6 +80,10 @@ public:
     void saveProgress();
     void loadProgress();
 
+    // filename inside the per-user directory from SDL_GetPrefPath, or in
+    // the working directory if SDL has none
+    std::string getSavePath(const std::string& filename) const { return m_prefPath + filename; }
+
 private:
     Game() = default;
     ~Game() = default;
@@ -104,6 +109,8 @@ private:
 
     GameStateType m_currentStateType = GameStateType::Menu;
     
+    std::string m_prefPath;
+
     int m_screenWidth = DEFAULT_SCREEN_WIDTH;
     int m_screenHeight = DEFAULT_SCREEN_HEIGHT;
     float m_deltaTime = 0.0f;
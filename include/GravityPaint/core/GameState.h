@@ -1,10 +1,15 @@
 #pragma once
 
 #include "GravityPaint/Types.h"
+#include "GravityPaint/sim/Replay.h"
+#include <random>
 
 namespace GravityPaint {
 
 class Game;
+class SimulationThread;
+struct RenderSnapshot;
+struct WorldSnapshot;
 
 class GameState {
 public:
@@ -40,6 +45,7 @@ private:
 class PlayingState : public GameState {
 public:
     explicit PlayingState(Game* game);
+    ~PlayingState() override;
     void enter() override;
     void exit() override;
     void update(float deltaTime) override;
@@ -47,17 +53,31 @@ public:
     void handleInput(const TouchPoint& touch) override;
 
     void addGravityStroke(const GravityStroke& stroke);
+
+    // Rewinds to the snapshot taken in enter() without rebuilding the world.
+    // Returns false if the world can't be restored in place.
+    bool restartFromSnapshot();
     const std::vector<GravityStroke>& getStrokes() const { return m_gravityStrokes; }
 
 private:
-    void updateGravityStrokes(float deltaTime);
-    void checkLevelCompletion();
+    size_t getStrokeLimit() const;
+    void checkLevelCompletion(const RenderSnapshot& snapshot);
     void updateParticles(float deltaTime);
     void spawnGoalParticles(const Vec2& position, const Color& color);
     void spawnCollisionParticles(const Vec2& position, const Color& color);
-
-    std::vector<GravityStroke> m_gravityStrokes;
+    void playContactEffects(const RenderSnapshot& snapshot);
+    float randomUnit();  // Cosmetic effects only, seeded per attempt
+
+    std::unique_ptr<SimulationThread> m_simulation;
+    std::unique_ptr<WorldSnapshot> m_startSnapshot;
+    std::unique_ptr<ReplayRecorder> m_recorder;
+    Replay m_replayHeader;
+    std::mt19937 m_effectsRng;
+    std::vector<GravityStroke> m_gravityStrokes;  // Mirror of the latest snapshot
     std::vector<SimpleParticle> m_particles;
+    std::vector<int> m_celebratedObjects;
+    const RenderSnapshot* m_snapshot = nullptr;  // Acquired once per frame in update()
+    uint64_t m_contactTick = 0;  // Contacts below this tick have been played
     GravityStroke m_currentStroke;
     bool m_isDrawingStroke = false;
     float m_levelTime = 0.0f;
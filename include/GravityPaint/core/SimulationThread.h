@@ -0,0 +1,100 @@
+#pragma once
+
+#include "GravityPaint/Types.h"
+#include "GravityPaint/Constants.h"
+#include "GravityPaint/core/SpscQueue.h"
+#include "GravityPaint/physics/PhysicsWorld.h"
+#include "GravityPaint/sim/LevelSimulation.h"
+#include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace GravityPaint {
+
+class LevelManager;
+
+// Everything PlayingState needs to draw and score one simulation step
+struct RenderSnapshot {
+    std::vector<ObjectSnapshot> objects;
+    std::vector<GravityStroke> strokes;  // field handles are cleared
+    std::vector<ContactEvent> contacts;  // Not yet consumed, oldest first; see acquireSnapshot()
+    std::vector<Vec2> movers;  // Moving obstacle centers, in level obstacle order
+    float objectiveProgress = 0.0f;
+    bool objectiveComplete = false;
+    bool objectiveFailed = false;
+    uint64_t step = 0;
+    uint64_t tick = 0;  // Physics ticks completed; every contact has a lower tick
+    PhysicsStepStats stepStats;
+};
+
+// Steps physics, spawns and objectives on its own thread and publishes
+// triple-buffered RenderSnapshots, so a slow physics step never blocks
+// presentation. The web build has no threads: update() steps inline.
+//
+// While running, the thread owns the PhysicsWorld, the LevelManager's level
+// state and the LevelSimulation. Call stop() before touching them.
+class SimulationThread {
+public:
+    SimulationThread(PhysicsWorld* physics, LevelManager* levelManager);
+    ~SimulationThread();
+
+    void start();
+    void stop();
+    bool isRunning() const { return m_running; }
+    bool isThreaded() const;
+
+    // Level setup, stroke limit and replay recording; only while stopped
+    LevelSimulation& getLevelSimulation() { return m_level; }
+
+    // Main thread: queue a committed stroke for the simulation
+    bool submitStroke(const GravityStroke& stroke);
+
+    // Drops all committed strokes; only valid while stopped
+    void clearStrokes();
+
+    // Main thread, once per frame. Steps inline when there is no thread.
+    void update(float deltaTime);
+
+    // Main thread: latest published snapshot, stable until the next call.
+    // Contacts accumulate on the simulation side until a snapshot holding
+    // them is acquired, so skipped snapshots lose none. One published while
+    // its predecessor was being acquired may repeat some; skip contacts
+    // whose tick is below the previous snapshot's tick.
+    const RenderSnapshot& acquireSnapshot();
+
+private:
+    void threadMain();
+    void step(float deltaTime);
+    void publish();
+
+    PhysicsWorld* m_physics;
+    LevelManager* m_levelManager;
+    LevelSimulation m_level;
+
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+
+    // Owned by the simulation side
+    SpscQueue<GravityStroke, 64> m_strokeQueue;
+    uint64_t m_step = 0;
+
+    // Contacts since the last consumed snapshot, capped so a reader that
+    // stops acquiring can't grow it without bound
+    static constexpr size_t MAX_PENDING_CONTACTS = CONTACT_EVENT_CAPACITY * 4;
+    std::vector<ContactEvent> m_pendingContacts;
+
+    // Written by the reader: tick of the snapshot it last acquired
+    std::atomic<uint64_t> m_consumedTick{0};
+
+    // Triple buffer: the writer fills m_back, swaps it with the shared
+    // middle slot, and the reader swaps the middle slot into m_front when
+    // the fresh bit is set. Neither side ever blocks.
+    static constexpr int FRESH_BIT = 4;
+    std::array<RenderSnapshot, 3> m_buffers;
+    int m_back = 0;
+    std::atomic<int> m_middle{1};
+    int m_front = 2;
+};
+
+} // namespace GravityPaint
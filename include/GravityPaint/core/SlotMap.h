@@ -0,0 +1,131 @@
+#pragma once
+
+#include "GravityPaint/Types.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace GravityPaint {
+
+// Dense, contiguous storage with O(1) insert and remove and generational
+// handles. Values live in one vector and are iterated in place; removing
+// one moves the last value into its hole, so raw pointers and references
+// into the map are only good until the next insert or remove. Hold a
+// SlotHandle across those and resolve it with get().
+template <typename T>
+class SlotMap {
+public:
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    template <typename... Args>
+    SlotHandle emplace(Args&&... args) {
+        uint32_t slot;
+        if (!m_freeSlots.empty()) {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(m_slots.size());
+            m_slots.push_back(Slot());
+        }
+
+        m_slots[slot].dense = static_cast<uint32_t>(m_values.size());
+        m_values.emplace_back(std::forward<Args>(args)...);
+        m_denseToSlot.push_back(slot);
+        return SlotHandle{slot, m_slots[slot].generation};
+    }
+
+    // Returns false if the handle was already stale
+    bool remove(SlotHandle handle) {
+        if (!contains(handle)) return false;
+
+        uint32_t dense = m_slots[handle.index].dense;
+        uint32_t last = static_cast<uint32_t>(m_values.size() - 1);
+        if (dense != last) {
+            m_values[dense] = std::move(m_values[last]);
+            m_denseToSlot[dense] = m_denseToSlot[last];
+            m_slots[m_denseToSlot[dense]].dense = dense;
+        }
+        m_values.pop_back();
+        m_denseToSlot.pop_back();
+
+        // Generation 0 is reserved for default handles
+        Slot& slot = m_slots[handle.index];
+        slot.dense = INVALID;
+        slot.generation = slot.generation == UINT32_MAX ? 1 : slot.generation + 1;
+        m_freeSlots.push_back(handle.index);
+        return true;
+    }
+
+    bool contains(SlotHandle handle) const {
+        return handle.index < m_slots.size()
+            && m_slots[handle.index].generation == handle.generation
+            && m_slots[handle.index].dense != INVALID;
+    }
+
+    T* get(SlotHandle handle) {
+        return contains(handle) ? &m_values[m_slots[handle.index].dense] : nullptr;
+    }
+    const T* get(SlotHandle handle) const {
+        return contains(handle) ? &m_values[m_slots[handle.index].dense] : nullptr;
+    }
+
+    // Slot indices stay fixed for an element's lifetime, which makes them
+    // usable as compact back-references (e.g. broadphase user data)
+    T& atSlot(uint32_t slot) { return m_values[m_slots[slot].dense]; }
+    const T& atSlot(uint32_t slot) const { return m_values[m_slots[slot].dense]; }
+
+    SlotHandle handleAt(size_t dense) const {
+        uint32_t slot = m_denseToSlot[dense];
+        return SlotHandle{slot, m_slots[slot].generation};
+    }
+
+    void clear() {
+        m_values.clear();
+        m_denseToSlot.clear();
+        m_freeSlots.clear();
+        for (uint32_t i = static_cast<uint32_t>(m_slots.size()); i-- > 0;) {
+            Slot& slot = m_slots[i];
+            if (slot.dense != INVALID) {
+                slot.generation = slot.generation == UINT32_MAX ? 1 : slot.generation + 1;
+            }
+            slot.dense = INVALID;
+            m_freeSlots.push_back(i);
+        }
+    }
+
+    void reserve(size_t capacity) {
+        m_values.reserve(capacity);
+        m_denseToSlot.reserve(capacity);
+        m_slots.reserve(capacity);
+    }
+
+    size_t size() const { return m_values.size(); }
+    bool empty() const { return m_values.empty(); }
+
+    T& operator[](size_t dense) { return m_values[dense]; }
+    const T& operator[](size_t dense) const { return m_values[dense]; }
+    T& back() { return m_values.back(); }
+    const T& back() const { return m_values.back(); }
+
+    iterator begin() { return m_values.begin(); }
+    iterator end() { return m_values.end(); }
+    const_iterator begin() const { return m_values.begin(); }
+    const_iterator end() const { return m_values.end(); }
+
+private:
+    static constexpr uint32_t INVALID = UINT32_MAX;
+
+    struct Slot {
+        uint32_t dense = INVALID;
+        uint32_t generation = 1;
+    };
+
+    std::vector<T> m_values;
+    std::vector<uint32_t> m_denseToSlot;
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;  // Reused last-in first-out
+};
+
+} // namespace GravityPaint
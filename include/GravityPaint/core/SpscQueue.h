@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace GravityPaint {
+
+// Bounded lock-free queue for exactly one producer and one consumer thread.
+// One slot is kept free to tell a full ring from an empty one.
+template <typename T, size_t Capacity>
+class SpscQueue {
+public:
+    // Producer side; returns false when the queue is full
+    bool push(T value) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t next = (tail + 1) % Capacity;
+        if (next == m_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        m_items[tail] = std::move(value);
+        m_tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; returns false when the queue is empty
+    bool pop(T& value) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(m_items[head]);
+        m_head.store((head + 1) % Capacity, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+private:
+    std::array<T, Capacity> m_items;
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+};
+
+} // namespace GravityPaint
@@ -14,6 +14,7 @@ class GravityField;
 class DeformableSurface;
 class ParticleSystem;
 class Camera;
+struct ObstacleData;
 
 class Renderer {
 public:
@@ -44,11 +45,13 @@ public:
                         float dashLength = 10.0f, float gapLength = 5.0f);
 
     // Game-specific drawing
-    void drawPhysicsObject(const PhysicsObject* object);
+    void drawPhysicsObject(const PhysicsObject* object, float alpha = 1.0f);
+    void drawObjectSnapshot(const ObjectSnapshot& object);
     void drawGravityField(const GravityField* field);
     void drawGravityStroke(const GravityStroke& stroke);
     void drawDeformableSurface(const DeformableSurface* surface);
     void drawGoalZone(const Rect& zone);
+    void drawObstacle(const ObstacleData& obstacle, const Vec2& position);
     void drawTrail(const std::vector<Vec2>& trail, const Color& color);
     void drawEnergyBar(const Vec2& position, float energy, float maxEnergy);
 
@@ -69,9 +69,11 @@ public:
     void addSpawnPoint(const SpawnPoint& spawn);
     void clearSpawnPoints() { m_spawnPoints.clear(); }
 
-    // Goal zone
-    Rect getGoalZone() const { return m_goalZone; }
-    void setGoalZone(const Rect& zone) { m_goalZone = zone; }
+    // Goal zones; setGoalZone replaces them all with one
+    const std::vector<Rect>& getGoalZones() const { return m_goalZones; }
+    Rect getGoalZone() const { return m_goalZones.empty() ? Rect(0, 0, 0, 0) : m_goalZones.front(); }
+    void setGoalZone(const Rect& zone) { m_goalZones.assign(1, zone); }
+    void addGoalZone(const Rect& zone) { m_goalZones.push_back(zone); }
 
     // Obstacles
     const std::vector<ObstacleData>& getObstacles() const { return m_obstacles; }
@@ -120,7 +122,7 @@ private:
     float m_timeLimit = LEVEL_TIME_LIMIT;
 
     std::vector<SpawnPoint> m_spawnPoints;
-    Rect m_goalZone = Rect(0, 0, 0, 0);
+    std::vector<Rect> m_goalZones;
     std::vector<ObstacleData> m_obstacles;
     std::vector<GravityZoneData> m_gravityZones;
 
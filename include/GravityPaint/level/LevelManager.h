@@ -3,6 +3,7 @@
 #include "GravityPaint/Types.h"
 #include <vector>
 #include <memory>
+#include <random>
 #include <string>
 
 namespace GravityPaint {
@@ -70,17 +71,22 @@ public:
 
     // Spawn management
     void spawnObjects(PhysicsWorld* physics);
+    void markInitialSpawns();  // Objects already restored from a WorldSnapshot
     void updateSpawns(float deltaTime, PhysicsWorld* physics);
     bool allObjectsSpawned() const { return m_allSpawned; }
 
-    // Level generation (for endless mode)
+    // Level generation (for endless mode). Seeded so replays regenerate
+    // the same levels; the default seed comes from std::random_device.
     std::unique_ptr<Level> generateProceduralLevel(int difficulty);
+    void setRandomSeed(uint32_t seed);
+    uint32_t getRandomSeed() const { return m_randomSeed; }
 
     // Save/Load progress
     bool saveProgress(const std::string& filepath);
     bool loadProgress(const std::string& filepath);
     
     void updateObjectiveProgress(PhysicsWorld* physics);
+    void recordContacts(const std::vector<ContactEvent>& contacts);
 
 private:
     void createBuiltInLevels();
@@ -107,6 +113,9 @@ private:
     float m_spawnTimer = 0.0f;
     bool m_allSpawned = false;
 
+    uint32_t m_randomSeed = 0;
+    std::mt19937 m_rng;
+
     static const LevelProgress s_emptyProgress;
 };
 
@@ -3,6 +3,7 @@
 #include "GravityPaint/Types.h"
 #include <string>
 #include <functional>
+#include <vector>
 
 namespace GravityPaint {
 
@@ -18,6 +19,9 @@ public:
     virtual float getProgress() const = 0;
     virtual std::string getDescription() const = 0;
 
+    // Contacts merged after a physics tick; most objectives ignore them
+    virtual void onContacts(const std::vector<ContactEvent>& /*contacts*/) {}
+
     ObjectiveType getType() const { return m_type; }
     bool isFailed() const { return m_failed; }
 
@@ -90,6 +94,7 @@ public:
     bool isComplete() const override;
     float getProgress() const override;
     std::string getDescription() const override;
+    void onContacts(const std::vector<ContactEvent>& contacts) override;
 
     void recordCollision();
     void resetChain();
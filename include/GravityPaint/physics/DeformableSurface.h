@@ -1,27 +1,26 @@
 #pragma once
 
 #include "GravityPaint/Types.h"
+#include "GravityPaint/Constants.h"
 #include <box2d/box2d.h>
+#include <array>
+#include <cstdint>
 #include <vector>
 
 namespace GravityPaint {
 
-struct SurfaceNode {
-    Vec2 position;
-    Vec2 restPosition;
-    Vec2 velocity;
-    float mass = 1.0f;
-    bool isFixed = false;
-};
-
-struct SurfaceSpring {
-    int nodeA;
-    int nodeB;
-    float restLength;
-    float stiffness;
-    float damping;
-};
-
+// Mass-spring membrane. Node and spring state are structure-of-arrays.
+// The explicit solver runs the springs as a fixed stencil over the node
+// grid: each of the four spring directions is one impulse per anchor node
+// from contiguous loads, and every node then sums its eight neighbours'
+// impulses with shifted loads. XPBD updates positions spring by spring,
+// so it solves springs grouped by color, where no two springs in a color
+// share a node, four at a time with Float4.
+//
+// A surface at rest sleeps and update() returns immediately. An impact
+// wakes only the node columns it reaches plus a margin; that region
+// grows while motion reaches its edges and the surface goes back to
+// sleep once every node has settled.
 class DeformableSurface {
 public:
     DeformableSurface(const Vec2& position, float width, float height, int resolutionX = 10, int resolutionY = 5);
@@ -31,6 +30,13 @@ public:
     void applyImpact(const Vec2& point, float force);
     void reset();
 
+    bool isAwake() const { return m_awake; }
+    int getAwakeColumnCount() const { return m_awake ? m_columnEnd - m_columnBegin : 0; }
+    size_t getActiveSpringCount() const;  // Springs solved per pass while awake
+
+    // Wakes node columns [first, last], as an impact there would
+    void wakeColumns(int first, int last);
+
     // Physics integration
     void attachToWorld(b2World* world);
     void detachFromWorld();
@@ -40,8 +46,17 @@ public:
     float getWidth() const { return m_width; }
     float getHeight() const { return m_height; }
 
-    const std::vector<SurfaceNode>& getNodes() const { return m_nodes; }
-    const std::vector<SurfaceSpring>& getSprings() const { return m_springs; }
+    // Nodes are row-major, index = y * resolutionX + x
+    size_t getNodeCount() const { return m_posX.size(); }
+    Vec2 getNodePosition(size_t index) const { return Vec2(m_posX[index], m_posY[index]); }
+    Vec2 getNodeRestPosition(size_t index) const { return Vec2(m_restX[index], m_restY[index]); }
+    bool isNodeFixed(size_t index) const { return m_invMass[index] == 0.0f; }
+
+    // Springs are stored in color order
+    size_t getSpringCount() const { return m_springA.size(); }
+    int getSpringNodeA(size_t index) const { return m_springA[index]; }
+    int getSpringNodeB(size_t index) const { return m_springB[index]; }
+    size_t getSpringColorCount() const { return m_colorStart.empty() ? 0 : m_colorStart.size() - 1; }
 
     // Visual
     Color getColor() const { return m_color; }
@@ -57,24 +72,109 @@ public:
     void setElasticity(float elasticity) { m_elasticity = elasticity; }
     float getElasticity() const { return m_elasticity; }
 
-    // Check if a point is near the surface
+    // XPBD treats springs as compliant distance constraints and stays
+    // stable at any stiffness in a single step; more iterations make
+    // stiff surfaces converge closer to their rest lengths
+    void setSolver(SurfaceSolver solver) { m_solver = solver; }
+    SurfaceSolver getSolver() const { return m_solver; }
+    void setIterations(int iterations);
+    int getIterations() const { return m_iterations; }
+
+    // Check if a point is near the surface. Points outside the node
+    // bounds are rejected at once; otherwise only nearby grid cells are read.
     bool isPointNear(const Vec2& point, float threshold = 20.0f) const;
     Vec2 getNearestPoint(const Vec2& point) const;
 
+    // Bounds of the current node positions
+    Rect getBounds() const {
+        return Rect(m_boundsMinX, m_boundsMinY, m_boundsMaxX - m_boundsMinX, m_boundsMaxY - m_boundsMinY);
+    }
+
 private:
     void createMesh();
     void createSprings();
+    void addSpring(int nodeA, int nodeB, float restLength, float stiffness, float damping);
+    void colorSprings();
     void updatePhysics(float deltaTime);
-    void applyConstraints();
-    
+    void updateXPBD(float deltaTime);
+    void solveSprings(int direction, float deltaTime);
+    void integrateSprings(size_t begin, size_t end, float deltaTime);
+    void integrateNodes(size_t begin, size_t end, float deltaTime, float damping);
+    void integrateRegion(float deltaTime, float damping);
+    void activeSprings(size_t color, size_t& begin, size_t& end) const;
+    void updateRestState(float deltaTime);
+    void sleep();
+    void rebuildGrid();
+    int gridColumn(float x) const;
+    int gridRow(float y) const;
+    int findNearestNode(const Vec2& point) const;
+    void solveConstraints(size_t begin, size_t end, float deltaTime);
+
+    // Stencil directions of the explicit solver, named by the spring that
+    // starts at anchor node (x, y): to (x+1, y), (x, y+1), (x+1, y+1), and
+    // from (x+1, y) to (x, y+1)
+    enum StencilDirection { Horizontal, Vertical, DiagonalDown, DiagonalUp, STENCIL_DIRECTIONS };
+
     Vec2 m_position;
     float m_width;
     float m_height;
     int m_resolutionX;
     int m_resolutionY;
 
-    std::vector<SurfaceNode> m_nodes;
-    std::vector<SurfaceSpring> m_springs;
+    // Nodes; fixed nodes have zero inverse mass and never move
+    std::vector<float> m_posX;
+    std::vector<float> m_posY;
+    std::vector<float> m_velX;
+    std::vector<float> m_velY;
+    std::vector<float> m_restX;
+    std::vector<float> m_restY;
+    std::vector<float> m_invMass;
+    std::vector<float> m_prevX;  // XPBD: positions at the start of the step
+    std::vector<float> m_prevY;
+
+    // Springs sorted by color; color c is [m_colorStart[c], m_colorStart[c + 1])
+    std::vector<int32_t> m_springA;
+    std::vector<int32_t> m_springB;
+    std::vector<float> m_springRest;
+    std::vector<float> m_springStiffness;
+    std::vector<float> m_springDamping;
+    std::vector<uint32_t> m_colorStart;
+    std::vector<float> m_springLambda;  // XPBD: accumulated multipliers for this step
+
+    // Explicit solver: spring constants per stencil direction and the last
+    // impulse per anchor node. Impulse arrays start with m_stencilPad zeros
+    // so the node pass can read its up-left neighbours on the first row, and
+    // they are zero outside the solved springs.
+    std::array<float, STENCIL_DIRECTIONS> m_stencilRest{};
+    std::array<float, STENCIL_DIRECTIONS> m_stencilStiffness{};
+    std::array<float, STENCIL_DIRECTIONS> m_stencilDamping{};
+    std::array<std::vector<float>, STENCIL_DIRECTIONS> m_impulseX;
+    std::array<std::vector<float>, STENCIL_DIRECTIONS> m_impulseY;
+    size_t m_stencilPad = 0;
+
+    // Awake region, node columns [m_columnBegin, m_columnEnd). Nodes
+    // outside it are exactly at rest.
+    bool m_awake = false;
+    int m_columnBegin = 0;
+    int m_columnEnd = 0;
+    float m_restTime = 0.0f;
+
+    // Uniform grid of nodes over the bounds, rebuilt after awake updates.
+    // Cell c holds m_gridNodes[m_gridStart[c], m_gridStart[c + 1]).
+    float m_boundsMinX = 0.0f;
+    float m_boundsMinY = 0.0f;
+    float m_boundsMaxX = 0.0f;
+    float m_boundsMaxY = 0.0f;
+    float m_gridCellSize = 1.0f;
+    float m_gridInvCellSize = 1.0f;
+    int m_gridColumns = 0;
+    int m_gridRows = 0;
+    std::vector<uint32_t> m_gridStart;
+    std::vector<uint32_t> m_gridNodes;
+    std::vector<uint32_t> m_gridCellOf;  // Rebuild scratch, cell per node
+
+    SurfaceSolver m_solver = SurfaceSolver::Springs;
+    int m_iterations = SURFACE_XPBD_ITERATIONS;
     std::vector<b2Body*> m_bodies;
 
     b2World* m_world = nullptr;
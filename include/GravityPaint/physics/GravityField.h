@@ -1,9 +1,12 @@
 #pragma once
 
 #include "GravityPaint/Types.h"
+#include "GravityPaint/physics/SegmentBVH.h"
 
 namespace GravityPaint {
 
+struct FieldState;
+
 class GravityField {
 public:
     GravityField(const Vec2& position, const Vec2& direction, float strength, float radius);
@@ -40,9 +43,22 @@ public:
     void setMaxLifetime(float lifetime) { m_maxLifetime = lifetime; }
     bool isExpired() const { return m_lifetime >= m_maxLifetime && m_maxLifetime > 0; }
 
+    // Polyline fields act along a path with distance-to-segment falloff
+    void setPath(const std::vector<Vec2>& points);
+    bool hasPath() const { return !m_path.empty(); }
+    const SegmentBVH& getPath() const { return m_path; }
+
     // Pulse effect for visualization
     float getPulsePhase() const { return m_pulsePhase; }
 
+    // Broadphase proxy owned by PhysicsWorld (-1 = not indexed)
+    int getProxyId() const { return m_proxyId; }
+    void setProxyId(int proxyId) { m_proxyId = proxyId; }
+
+    // Mutable state for WorldSnapshot; type, color and path are left alone
+    void captureState(FieldState& state) const;
+    void restoreState(const FieldState& state);
+
 private:
     Vec2 m_position;
     Vec2 m_direction;
@@ -54,6 +70,8 @@ private:
     float m_lifetime = 0.0f;
     float m_maxLifetime = 0.0f;  // 0 = permanent
     float m_pulsePhase = 0.0f;
+    int m_proxyId = -1;
+    SegmentBVH m_path;
 };
 
 // Specialized gravity zone types
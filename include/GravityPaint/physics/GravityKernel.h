@@ -0,0 +1,21 @@
+#pragma once
+
+#include "GravityPaint/Types.h"
+#include <cstddef>
+
+namespace GravityPaint {
+
+class GravityField;
+
+// Batched equivalent of GravityField::calculateForce().
+// Adds the field's force at every (posX[i], posY[i]) into (forceX[i], forceY[i]).
+// Positions are structure-of-arrays; the zone type is dispatched once per call
+// to a loop specialized for that ZoneType.
+// Path fields with up to a few dozen segments test every segment four
+// positions at a time; longer paths walk the stroke's BVH per position.
+void accumulateFieldForces(const GravityField& field,
+                           const float* posX, const float* posY,
+                           float* forceX, float* forceY,
+                           size_t count);
+
+} // namespace GravityPaint
@@ -3,16 +3,29 @@
 #include "GravityPaint/Types.h"
 #include <box2d/box2d.h>
 #include <vector>
+#include <atomic>
 
 namespace GravityPaint {
 
+struct ObjectState;
+
 class PhysicsObject {
 public:
     PhysicsObject(b2World* world, ObjectType type, const Vec2& position, float size);
+    // Adopts an idle body from PhysicsWorld's pool. Its fixture is rebuilt
+    // only when bodySize (what it was built for) differs from size.
+    PhysicsObject(b2Body* pooledBody, float bodySize, ObjectType type, const Vec2& position, float size);
     ~PhysicsObject();
 
+    // Move-only; the body's user data is re-pointed at the new address so
+    // objects can live by value in PhysicsWorld's slot map
+    PhysicsObject(PhysicsObject&& other) noexcept;
+    PhysicsObject& operator=(PhysicsObject&& other) noexcept;
+    PhysicsObject(const PhysicsObject&) = delete;
+    PhysicsObject& operator=(const PhysicsObject&) = delete;
+
     void update(float deltaTime);
-    void applyForce(const Vec2& force);
+    void applyForce(const Vec2& force, bool wake = true);
     void applyImpulse(const Vec2& impulse);
     void setVelocity(const Vec2& velocity);
 
@@ -24,6 +37,11 @@ public:
     void setAngle(float angle);
     float getAngularVelocity() const;
 
+    // Pose before the most recent physics tick, for render interpolation
+    void storePreviousTransform();
+    Vec2 getInterpolatedPosition(float alpha) const;
+    float getInterpolatedAngle(float alpha) const;
+
     // Object properties
     ObjectType getType() const { return m_type; }
     float getSize() const { return m_size; }
@@ -36,6 +54,14 @@ public:
     void transferEnergy(PhysicsObject* other, float rate);
     Color getEnergyColor() const;
 
+    // Copies drawable state; reuses the snapshot's trail storage.
+    // alpha blends between the previous and current tick pose.
+    void fillSnapshot(ObjectSnapshot& snapshot, float alpha = 1.0f) const;
+
+    // Full simulation state for WorldSnapshot; trails are appended to a shared pool
+    void captureState(ObjectState& state, std::vector<Vec2>& trails) const;
+    void restoreState(const ObjectState& state, const std::vector<Vec2>& trails);
+
     // Visual
     Color getColor() const { return m_color; }
     void setColor(const Color& color) { m_color = color; }
@@ -47,21 +73,49 @@ public:
     // State
     bool isActive() const { return m_active; }
     void setActive(bool active);
-    bool isInGoal() const { return m_inGoal; }
-    void setInGoal(bool inGoal) { m_inGoal = inGoal; }
     bool isCollected() const { return m_collected; }
     void setCollected(bool collected) { m_collected = collected; }
+
+    // Driven by goal sensor contacts. Goals may overlap, so the object
+    // touches a goal while any sensor does; PhysicsWorld scores it once its
+    // centre is inside one. Reaching a goal is sticky.
+    bool isTouchingGoal() const { return m_goalOverlaps > 0; }
     bool hasReachedGoal() const { return m_reachedGoal; }
-    void setReachedGoal(bool reached) { m_reachedGoal = reached; }
+    void enterGoal() { m_goalOverlaps++; }
+    void exitGoal();
+    bool reachGoal();  // True the first time the object reaches a goal
+
+    // Scored objects that have come to rest are turned into static bodies;
+    // they still block others but cost nothing in the solver
+    bool isFrozen() const { return m_frozen; }
+    void freeze();
+
+    // Physics LOD: the last evaluated field pull (acceleration) and whether
+    // it may be reused while the object stays asleep or far off-screen
+    const Vec2& getFieldForce() const { return m_fieldForce; }
+    bool isReducedRate() const { return m_reducedRate; }
+    void setFieldForce(const Vec2& force, bool reducedRate) {
+        m_fieldForce = force;
+        m_reducedRate = reducedRate;
+    }
 
     // Box2D access
     b2Body* getBody() const { return m_body; }
 
+    // Disables the body and hands it back for pooling; the object is left
+    // without a body and can only be destroyed
+    b2Body* releaseBody();
+
+    // Disabled bodies can be built ahead of time and adopted later
+    static b2Body* buildBody(b2World* world, ObjectType type, const Vec2& position, float size, bool enabled);
+
     // ID for tracking
     int getId() const { return m_id; }
 
 private:
-    void createBody(b2World* world, const Vec2& position);
+    static void buildFixture(b2Body* body, ObjectType type, float size);
+    void initColor();
+    void destroyBody();
     void updateTrail();
 
     b2Body* m_body = nullptr;
@@ -75,12 +129,19 @@ private:
     std::vector<Vec2> m_trail;
     float m_trailTimer = 0.0f;
 
+    Vec2 m_previousPosition;
+    float m_previousAngle = 0.0f;
+
     bool m_active = true;
-    bool m_inGoal = false;
+    int m_goalOverlaps = 0;
     bool m_collected = false;
     bool m_reachedGoal = false;
+    bool m_frozen = false;
+
+    Vec2 m_fieldForce;
+    bool m_reducedRate = false;
 
-    static int s_nextId;
+    static std::atomic<int> s_nextId;  // Shared by worlds on batch worker threads
 };
 
 } // namespace GravityPaint
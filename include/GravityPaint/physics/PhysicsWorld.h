@@ -2,27 +2,114 @@
 
 #include "GravityPaint/Types.h"
 #include "GravityPaint/Constants.h"
+#include "GravityPaint/physics/VectorFieldGrid.h"
+#include "GravityPaint/physics/WorldSnapshot.h"
+#include "GravityPaint/physics/PhysicsObject.h"
+#include "GravityPaint/physics/GravityField.h"
+#include "GravityPaint/physics/DeformableSurface.h"
+#include "GravityPaint/core/SlotMap.h"
 #include <box2d/box2d.h>
+#include <array>
 #include <vector>
+#include <cstdint>
 #include <memory>
+#include <utility>
 
 namespace GravityPaint {
 
-class PhysicsObject;
-class GravityField;
-class DeformableSurface;
+class PhysicsWorld;
 
+// Records object/object contacts while b2World::Step runs, merged per
+// pair as they arrive: Box2D reports a pair once per solver pass (and
+// again for TOI), so a tick keeps one record per touching pair. Nothing
+// is dispatched from inside the solver: PhysicsWorld drains the records
+// after the step and applies them. Goal sensors are handled as they begin
+// and end, since that only moves goal bookkeeping and nothing the solver
+// reads.
 class ContactListener : public b2ContactListener {
 public:
+    explicit ContactListener(PhysicsWorld* world) : m_world(world) { reserve(0); }
+
+    struct Record {
+        PhysicsObject* a = nullptr;  // Valid until the drain; Step never destroys objects
+        PhysicsObject* b = nullptr;
+        b2Vec2 point = b2Vec2(0.0f, 0.0f);
+        float normalImpulse = 0.0f;
+        bool began = false;
+        uint32_t sequence = 0;  // Drain order, the sort's tie-break
+    };
+
     void BeginContact(b2Contact* contact) override;
     void EndContact(b2Contact* contact) override;
     void PreSolve(b2Contact* contact, const b2Manifold* oldManifold) override;
     void PostSolve(b2Contact* contact, const b2ContactImpulse* impulse) override;
 
-    void setCollisionCallback(CollisionCallback callback) { m_callback = callback; }
+    // Room for pairCount pairs (at least CONTACT_EVENT_CAPACITY) before
+    // anything is dropped. Only grows, and only between steps.
+    void reserve(size_t pairCount);
+
+    // Merges into the pair's record: began is or-ed and the largest
+    // impulse keeps its point. Pairs past the capacity are counted and
+    // dropped rather than allocated for inside the solver.
+    void record(PhysicsObject* a, PhysicsObject* b, const b2Vec2& point, float normalImpulse, bool began);
+
+    // One record per pair, in the order pairs first appeared
+    std::vector<Record>& getRecords() { return m_records; }
+    void clear();
+    uint64_t getDroppedCount() const { return m_dropped; }
+    size_t getCapacity() const { return m_capacity; }
 
 private:
-    CollisionCallback m_callback;
+    void push(b2Contact* contact, float normalImpulse, bool began);
+    bool handleGoalSensor(b2Contact* contact, bool began);
+    size_t pairSlot(const PhysicsObject* a, const PhysicsObject* b) const;
+
+    PhysicsWorld* m_world;
+    std::vector<Record> m_records;
+    std::vector<int32_t> m_pairTable;    // Open-addressed, record index or -1
+    std::vector<uint32_t> m_recordSlot;  // Table slot of each record, for clear()
+    size_t m_capacity = 0;
+    uint64_t m_dropped = 0;  // Records that found the table full
+};
+
+// How often the step budget kicked in. Dropped time was cut by the
+// MAX_FRAME_DELTA clamp; dilated time was owed to the accumulator but
+// discarded because the substep or wall-clock budget ran out.
+struct PhysicsStepStats {
+    uint64_t ticks = 0;
+    uint64_t updates = 0;
+    uint64_t dilatedUpdates = 0;
+    int lastSubsteps = 0;
+    double droppedTime = 0.0;
+    double dilatedTime = 0.0;
+    uint64_t droppedContacts = 0;  // Contact pairs lost to a full listener
+
+    // Physics LOD, see applyGravityFields
+    uint64_t sleepingSkips = 0;    // Weak pulls that left a sleeping body asleep
+    uint64_t reducedRateSkips = 0; // Field evaluations skipped for idle objects
+    uint64_t frozenObjects = 0;    // Scored objects turned static
+    double collideMs = 0.0;        // Summed b2Profile times
+    double solveMs = 0.0;
+};
+
+// Spawn latency split by whether the body came from the pool or was
+// built on the spot, so the two can be compared in the same session
+struct PhysicsPoolStats {
+    uint64_t pooledSpawns = 0;
+    uint64_t builtSpawns = 0;
+    uint64_t fixtureRebuilds = 0;  // Pooled spawns whose size didn't match
+    double pooledSeconds = 0.0;
+    double builtSeconds = 0.0;
+};
+
+// Closest hit along a ray. object is null when static geometry (walls,
+// obstacles) was hit first.
+struct RayHit {
+    bool hit = false;
+    PhysicsObject* object = nullptr;
+    Vec2 point;   // Pixels
+    Vec2 normal;
+    float fraction = 1.0f;  // Along from -> to
 };
 
 class PhysicsWorld {
@@ -35,20 +122,101 @@ public:
     void update(float deltaTime);
     void reset();
 
-    // Object management
-    PhysicsObject* createObject(ObjectType type, const Vec2& position, float size = 1.0f);
-    void destroyObject(PhysicsObject* object);
+    // Copies every object, field and the paint grid into a contiguous
+    // snapshot. restoreSnapshot writes it back into the same bodies without
+    // recreating them; objects and fields created after the capture are
+    // destroyed. Returns false (world untouched) if a captured object or
+    // field no longer exists, in which case callers should fall back to
+    // reset() and a full respawn.
+    void captureSnapshot(WorldSnapshot& snapshot) const;
+    bool restoreSnapshot(const WorldSnapshot& snapshot);
+
+    // Fixed tick rate; snapped to 30, 60, 120 or 240 Hz
+    void setTickRate(int hz);
+    int getTickRate() const { return m_tickRate; }
+    float getTimestep() const { return m_timestep; }
+
+    // Fraction of a tick left in the accumulator. Draw objects at
+    // getInterpolatedPosition(alpha) to hide the tick/frame mismatch.
+    float getInterpolationAlpha() const { return m_accumulator / m_timestep; }
+
+    // Caps the work a single update() may do so a slow frame can't make the
+    // next one slower. maxSeconds <= 0 disables the wall-clock limit, which
+    // keeps offline runs deterministic.
+    void setStepBudget(int maxSubsteps, float maxSeconds);
+    const PhysicsStepStats& getStepStats() const { return m_stepStats; }
+    void resetStepStats() { m_stepStats = PhysicsStepStats(); }
+
+    // Physics LOD, on by default: idle objects reuse their field pull,
+    // weak pulls leave sleeping bodies asleep and scored objects freeze
+    // once at rest. Off applies every pull every tick, for comparison.
+    void setLodEnabled(bool enabled) {
+        m_lodEnabled = enabled;
+        m_lodRefresh = true;
+    }
+    bool isLodEnabled() const { return m_lodEnabled; }
+
+    // Called around every fixed tick with the tick index and timestep.
+    // Gameplay that must replay bit-exactly (stroke binding, spawns,
+    // objectives) hooks in here rather than running once per frame.
+    using TickCallback = std::function<void(uint64_t tick, float timestep)>;
+    void setPreTickCallback(TickCallback callback) { m_preTick = std::move(callback); }
+    void setPostTickCallback(TickCallback callback) { m_postTick = std::move(callback); }
+    uint64_t getTick() const { return m_tick; }
+
+    // Objects, fields and surfaces live in slot maps. Hold handles, not
+    // pointers: a pointer from get() is only good until the next create or
+    // destroy of the same kind, while a stale handle just resolves to null.
+    ObjectHandle createObject(ObjectType type, const Vec2& position, float size = 1.0f);
+    PhysicsObject* getObject(ObjectHandle handle) { return m_objects.get(handle); }
+    void destroyObject(ObjectHandle handle);
     void clearObjects();
 
+    // Destroyed and cleared objects leave their disabled bodies in a
+    // per-type pool; createObject re-enables one before building anew.
+    // Prewarming at level load moves body and fixture creation out of
+    // the spawn itself. The pool lives in the b2World, so shutdown()
+    // empties it. SpawnPoolBench compares the two spawn paths.
+    void prewarmBodies(ObjectType type, float size, int count);
+    const PhysicsPoolStats& getPoolStats() const { return m_poolStats; }
+
     // Gravity fields
-    GravityField* createGravityField(const Vec2& position, const Vec2& direction, float strength, float radius);
-    void removeGravityField(GravityField* field);
-    void applyGravityFromStrokes(const std::vector<GravityStroke>& strokes);
+    FieldHandle createGravityField(const Vec2& position, const Vec2& direction, float strength, float radius);
+    GravityField* getGravityField(FieldHandle handle) { return m_gravityFields.get(handle); }
+    void removeGravityField(FieldHandle handle);
+    void moveGravityField(FieldHandle handle, const Vec2& position);
+    void refreshGravityField(FieldHandle handle);  // Call after changing a field's radius or path
     void clearGravityFields();
+    const SlotMap<GravityField>& getGravityFields() const { return m_gravityFields; }
+
+    // Stroke fields are created once when a stroke is committed, updated in
+    // place while it fades and released when it expires
+    FieldHandle bindStrokeField(GravityStroke& stroke);
+    void releaseStrokeField(GravityStroke& stroke);
+    void applyGravityFromStrokes(const std::vector<GravityStroke>& strokes);
+
+    // Paint mode rasterizes strokes into a grid instead of binding fields
+    void setGravityMode(GravityMode mode);
+    GravityMode getGravityMode() const { return m_gravityMode; }
+    void setPaintDiffusion(float rate) { m_paintDiffusion = rate; }
+    const VectorFieldGrid& getPaintGrid() const { return m_paintGrid; }
+
+    // Batched field evaluation over structure-of-arrays positions (pixels).
+    // Writes the summed force of every field at each position.
+    void computeGravityForces(const float* posX, const float* posY,
+                              float* forceX, float* forceY, size_t count);
+
+    // Level gravity zones are static, so they are baked into a force grid once
+    GravityZone* createGravityZone(const Vec2& position, const Vec2& size, ZoneType type,
+                                   const Vec2& direction, float strength);
+    void bakeGravityZones();
+    void clearGravityZones();
+    const std::vector<std::unique_ptr<GravityZone>>& getGravityZones() const { return m_gravityZones; }
 
     // Deformable surfaces
-    DeformableSurface* createDeformableSurface(const Vec2& position, float width, float height);
-    void removeDeformableSurface(DeformableSurface* surface);
+    SurfaceHandle createDeformableSurface(const Vec2& position, float width, float height);
+    DeformableSurface* getDeformableSurface(SurfaceHandle handle) { return m_deformableSurfaces.get(handle); }
+    void removeDeformableSurface(SurfaceHandle handle);
 
     // World boundaries
     void createBoundaries(float width, float height);
@@ -59,23 +227,67 @@ public:
     b2Body* createStaticCircle(const Vec2& position, float radius);
     void destroyStaticBody(b2Body* body);
 
-    // Goal zones
+    // Level obstacles. Static ones are fixtures on a single compound body,
+    // so a level's scenery costs one body however many pieces it has.
+    // Moving ones are kinematic and ping-pong distance pixels along
+    // direction; their paths are precomputed per tick and all movers are
+    // driven in one pass before each step. Rotation is in radians.
+    void addStaticObstacle(const Vec2& position, const Vec2& size, float rotation, bool circle);
+    size_t addMovingObstacle(const Vec2& position, const Vec2& size, float rotation, bool circle,
+                             const Vec2& direction, float speed, float distance);
+    void clearObstacles();
+    size_t getMovingObstacleCount() const { return m_movers.size(); }
+    Vec2 getMovingObstaclePosition(size_t index, float alpha = 1.0f) const;
+
+    // Goal zones are static sensors; a level may have several, and they
+    // may overlap. An object reaches a goal when its centre is inside one:
+    // checked as its sensor contact begins and after each tick while it
+    // still touches a goal. The count of objects that have reached any
+    // goal is kept up to date as they do, so reading it is O(1).
     void createGoalZone(const Vec2& position, const Vec2& size);
-    bool isObjectInGoal(PhysicsObject* object) const;
-    std::vector<PhysicsObject*> getObjectsInGoal();
+    void clearGoalZones();
+    bool isObjectInGoal(const PhysicsObject* object) const;
+    int getGoalCount() const { return m_goalCount; }
 
-    // Queries
+    // Spatial queries run against Box2D's broadphase; sensors are ignored.
     PhysicsObject* getObjectAtPoint(const Vec2& point);
+
+    // One broadphase query over the bounds of all the points, writing one
+    // result per point. Pays off for points close together, such as one
+    // stroke's samples; for points spread across the world, call
+    // getObjectAtPoint per point. Allocates only to grow its scratch.
+    void getObjectsAtPoints(const Vec2* points, size_t count, PhysicsObject** results);
+
+    // Objects whose center lies inside area. Writes up to capacity and
+    // returns how many matched, which may be more.
+    size_t getObjectsInArea(const Rect& area, PhysicsObject** results, size_t capacity);
     std::vector<PhysicsObject*> getObjectsInArea(const Rect& area);
 
+    // Box2D walks its tree once per ray and clips it at each hit, which a
+    // shared walk can't improve on; cast several rays by calling this per ray
+    bool rayCast(const Vec2& from, const Vec2& to, RayHit& hit);
+
     // Accessors
     b2World* getBox2DWorld() const { return m_world.get(); }
-    const std::vector<std::unique_ptr<PhysicsObject>>& getObjects() const { return m_objects; }
+    const SlotMap<PhysicsObject>& getObjects() const { return m_objects; }
     Vec2 getGlobalGravity() const { return m_globalGravity; }
     void setGlobalGravity(const Vec2& gravity);
 
-    // Collision callbacks
-    void setCollisionCallback(CollisionCallback callback);
+    // FNV-1a over every object's type, transform, velocity and energy, in
+    // creation order. Equal hashes mean equal final states across runs.
+    uint64_t computeStateHash() const;
+
+    // Object contacts from the last tick, one per pair, ordered by id.
+    // Energy transfer has already been applied when the callback sees them.
+    const std::vector<ContactEvent>& getContactEvents() const { return m_contactEvents; }
+    void setContactCallback(ContactCallback callback) { m_contactCallback = std::move(callback); }
+
+    // What drainContacts does with a tick's records: orders each pair by
+    // id, sorts by pair, merges each pair into one event and transfers
+    // energy across pairs hit harder than CONTACT_IMPULSE_THRESHOLD.
+    // Records are reordered in place.
+    static void mergeContacts(std::vector<ContactListener::Record>& records, uint64_t tick,
+                              std::vector<ContactEvent>& events);
 
     // Debug
     void setDebugDraw(bool enable) { m_debugDraw = enable; }
@@ -86,26 +298,99 @@ public:
     static b2Vec2 toMeters(const Vec2& pixels);
 
 private:
+    friend class ContactListener;
+
+    void stepTick();  // One fixed tick: hooks, force stage, Box2D step, per-tick upkeep
     void applyGravityFields();
+    void updateMovers();
+    void syncMovers();
+    void rebuildMoverPaths();
+    void drainContacts();
+    void recycleBody(PhysicsObject& object);
+    void applyFieldForce(PhysicsObject& object, const Vec2& acceleration);
+    void updateGoalObjects();
+    bool isInsideGoal(const Vec2& position) const;
+    void onGoalEnter(PhysicsObject* object);
+    void onGoalExit(PhysicsObject* object);
     void updateDeformableSurfaces(float deltaTime);
+    b2AABB computeFieldAABB(const GravityField& field) const;
+    void refreshFieldProxy(GravityField& field);
+    void destroyFieldProxy(GravityField& field);
 
     std::unique_ptr<b2World> m_world;
     std::unique_ptr<ContactListener> m_contactListener;
+    std::vector<ContactEvent> m_contactEvents;
+    ContactCallback m_contactCallback;
+
+    SlotMap<PhysicsObject> m_objects;
 
-    std::vector<std::unique_ptr<PhysicsObject>> m_objects;
-    std::vector<std::unique_ptr<GravityField>> m_gravityFields;
-    std::vector<std::unique_ptr<DeformableSurface>> m_deformableSurfaces;
+    struct PooledBody {
+        b2Body* body;
+        float size;  // What its fixture was built for
+    };
+    std::array<std::vector<PooledBody>, OBJECT_TYPE_COUNT> m_bodyPool;
+    PhysicsPoolStats m_poolStats;
+    SlotMap<GravityField> m_gravityFields;
+    std::unique_ptr<b2DynamicTree> m_fieldTree;  // Broadphase over field AABBs, keyed by slot
+
+    // Scratch buffers for batched force evaluation (reused every frame)
+    std::vector<std::pair<int32, int32>> m_fieldPairs;  // (proxy id, position index)
+    std::vector<uint32_t> m_batchObjects;  // Dense indices into m_objects
+    bool m_lodRefresh = true;  // Fields changed; evaluate every object next tick
+    bool m_lodEnabled = true;
+    std::vector<float> m_batchPosX;
+    std::vector<float> m_batchPosY;
+    std::vector<float> m_batchForceX;
+    std::vector<float> m_batchForceY;
+    std::vector<b2Vec2> m_queryPoints;     // getObjectsAtPoints, in meters sorted by x
+    std::vector<uint32_t> m_queryOrder;    // Caller index of each sorted point
+    std::vector<float> m_gatherPosX;
+    std::vector<float> m_gatherPosY;
+    std::vector<float> m_gatherForceX;
+    std::vector<float> m_gatherForceY;
+    SlotMap<DeformableSurface> m_deformableSurfaces;
     std::vector<b2Body*> m_boundaryBodies;
     std::vector<b2Body*> m_staticBodies;
 
-    Rect m_goalZone;
-    bool m_hasGoalZone = false;
+    // Kinematic obstacle travelling origin -> origin + travel and back.
+    // Its path holds one position per tick of a round trip.
+    struct Mover {
+        b2Body* body;
+        b2Vec2 origin;
+        b2Vec2 travel;
+        float period;  // Seconds per round trip; 0 stands still
+        uint32_t pathStart;
+        uint32_t pathLength;
+    };
+    b2Body* m_obstacleBody = nullptr;  // Compound body for every static obstacle
+    std::vector<Mover> m_movers;
+    std::vector<b2Vec2> m_moverPaths;  // Every mover's path, back to back
+
+    std::vector<std::unique_ptr<GravityZone>> m_gravityZones;
+    std::vector<const GravityZone*> m_dragZones;  // Slow zones keep their analytic drag term
+    VectorFieldGrid m_zoneGrid;
+
+    GravityMode m_gravityMode = GravityMode::Fields;
+    VectorFieldGrid m_paintGrid;
+    float m_paintDiffusion = 0.0f;
+    Vec2 m_worldSize = Vec2(DEFAULT_SCREEN_WIDTH, DEFAULT_SCREEN_HEIGHT);
+
+    std::vector<b2Body*> m_goalBodies;
+    std::vector<Rect> m_goalRects;  // Pixels, one per goal body
+    int m_goalCount = 0;  // Objects that have reached a goal
 
     Vec2 m_globalGravity = Vec2(DEFAULT_GRAVITY_X, DEFAULT_GRAVITY_Y);
     bool m_debugDraw = false;
 
     float m_accumulator = 0.0f;
-    static constexpr float FIXED_TIMESTEP = 1.0f / 60.0f;
+    int m_tickRate = PHYSICS_TICK_RATE;
+    float m_timestep = 1.0f / PHYSICS_TICK_RATE;
+    int m_maxSubsteps = PHYSICS_MAX_SUBSTEPS;
+    float m_stepBudget = PHYSICS_STEP_BUDGET;
+    PhysicsStepStats m_stepStats;
+    uint64_t m_tick = 0;
+    TickCallback m_preTick;
+    TickCallback m_postTick;
 };
 
 } // namespace GravityPaint
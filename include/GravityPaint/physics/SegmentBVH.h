@@ -0,0 +1,44 @@
+#pragma once
+
+#include "GravityPaint/Types.h"
+#include <vector>
+
+namespace GravityPaint {
+
+// Bounding-volume hierarchy over the segments of a polyline.
+// Built once per stroke; answers closest-point queries in O(log n).
+class SegmentBVH {
+public:
+    void build(const std::vector<Vec2>& points);
+    void clear();
+
+    bool empty() const { return m_nodes.empty(); }
+    size_t getSegmentCount() const { return m_segments.size(); }
+    Rect getBounds() const;
+    const std::vector<Vec2>& getPoints() const { return m_points; }  // Segment i is points[i] to points[i + 1]
+
+    // Closest point on the polyline no farther than maxDistance.
+    // Returns false when every segment is out of reach.
+    bool findClosest(const Vec2& point, float maxDistance, Vec2& closest, float& distance) const;
+
+private:
+    struct Node {
+        float minX, minY, maxX, maxY;
+        int left = -1;   // Child indices for inner nodes
+        int right = -1;
+        int first = 0;   // Segment range for leaves
+        int count = 0;   // > 0 marks a leaf
+    };
+
+    int buildNode(int first, int count);
+    static float distanceSqToBox(const Node& node, const Vec2& point);
+
+    static constexpr int LEAF_SIZE = 4;
+    static constexpr int MAX_STACK = 64;
+
+    std::vector<Vec2> m_points;
+    std::vector<int> m_segments;  // Start point index of each segment, reordered by the build
+    std::vector<Node> m_nodes;
+};
+
+} // namespace GravityPaint
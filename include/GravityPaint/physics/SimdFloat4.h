@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define GRAVITYPAINT_SIMD_SSE2 1
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define GRAVITYPAINT_SIMD_NEON 1
+    #include <arm_neon.h>
+#endif
+
+namespace GravityPaint {
+
+// Minimal 4-wide float vector used by the batched physics kernels.
+// Maps to SSE2 on x86, NEON on ARM and plain arrays everywhere else (web).
+struct Float4 {
+#if defined(GRAVITYPAINT_SIMD_SSE2)
+    __m128 v;
+
+    static Float4 load(const float* p) { return {_mm_loadu_ps(p)}; }
+    static Float4 splat(float s) { return {_mm_set1_ps(s)}; }
+    static Float4 zero() { return {_mm_setzero_ps()}; }
+    void store(float* p) const { _mm_storeu_ps(p, v); }
+
+    friend Float4 operator+(Float4 a, Float4 b) { return {_mm_add_ps(a.v, b.v)}; }
+    friend Float4 operator-(Float4 a, Float4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+    friend Float4 operator*(Float4 a, Float4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+    friend Float4 operator/(Float4 a, Float4 b) { return {_mm_div_ps(a.v, b.v)}; }
+
+    static Float4 min(Float4 a, Float4 b) { return {_mm_min_ps(a.v, b.v)}; }
+    static Float4 max(Float4 a, Float4 b) { return {_mm_max_ps(a.v, b.v)}; }
+    static Float4 sqrt(Float4 a) { return {_mm_sqrt_ps(a.v)}; }
+
+    // Lane masks are all-ones / all-zeros floats
+    static Float4 lessEqual(Float4 a, Float4 b) { return {_mm_cmple_ps(a.v, b.v)}; }
+    static Float4 greaterEqual(Float4 a, Float4 b) { return {_mm_cmpge_ps(a.v, b.v)}; }
+    static Float4 maskAnd(Float4 a, Float4 b) { return {_mm_and_ps(a.v, b.v)}; }
+    static Float4 select(Float4 mask, Float4 a) { return {_mm_and_ps(mask.v, a.v)}; }
+    static Float4 blend(Float4 mask, Float4 a, Float4 b) {
+        return {_mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v))};
+    }
+    static bool any(Float4 mask) { return _mm_movemask_ps(mask.v) != 0; }
+
+#elif defined(GRAVITYPAINT_SIMD_NEON)
+    float32x4_t v;
+
+    static Float4 load(const float* p) { return {vld1q_f32(p)}; }
+    static Float4 splat(float s) { return {vdupq_n_f32(s)}; }
+    static Float4 zero() { return {vdupq_n_f32(0.0f)}; }
+    void store(float* p) const { vst1q_f32(p, v); }
+
+    friend Float4 operator+(Float4 a, Float4 b) { return {vaddq_f32(a.v, b.v)}; }
+    friend Float4 operator-(Float4 a, Float4 b) { return {vsubq_f32(a.v, b.v)}; }
+    friend Float4 operator*(Float4 a, Float4 b) { return {vmulq_f32(a.v, b.v)}; }
+    friend Float4 operator/(Float4 a, Float4 b) {
+#if defined(__aarch64__)
+        return {vdivq_f32(a.v, b.v)};
+#else
+        float32x4_t r = vrecpeq_f32(b.v);
+        r = vmulq_f32(vrecpsq_f32(b.v, r), r);
+        r = vmulq_f32(vrecpsq_f32(b.v, r), r);
+        return {vmulq_f32(a.v, r)};
+#endif
+    }
+
+    static Float4 min(Float4 a, Float4 b) { return {vminq_f32(a.v, b.v)}; }
+    static Float4 max(Float4 a, Float4 b) { return {vmaxq_f32(a.v, b.v)}; }
+    static Float4 sqrt(Float4 a) {
+#if defined(__aarch64__)
+        return {vsqrtq_f32(a.v)};
+#else
+        // sqrt(x) = x * rsqrt(x), refined twice; zero lanes stay zero
+        float32x4_t r = vrsqrteq_f32(a.v);
+        r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a.v, r), r), r);
+        r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a.v, r), r), r);
+        uint32x4_t nonZero = vcgtq_f32(a.v, vdupq_n_f32(0.0f));
+        return {vreinterpretq_f32_u32(vandq_u32(nonZero, vreinterpretq_u32_f32(vmulq_f32(a.v, r))))};
+#endif
+    }
+
+    static Float4 lessEqual(Float4 a, Float4 b) { return {vreinterpretq_f32_u32(vcleq_f32(a.v, b.v))}; }
+    static Float4 greaterEqual(Float4 a, Float4 b) { return {vreinterpretq_f32_u32(vcgeq_f32(a.v, b.v))}; }
+    static Float4 maskAnd(Float4 a, Float4 b) {
+        return {vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a.v), vreinterpretq_u32_f32(b.v)))};
+    }
+    static Float4 select(Float4 mask, Float4 a) { return maskAnd(mask, a); }
+    static Float4 blend(Float4 mask, Float4 a, Float4 b) {
+        return {vbslq_f32(vreinterpretq_u32_f32(mask.v), a.v, b.v)};
+    }
+    static bool any(Float4 mask) {
+        uint32x4_t m = vreinterpretq_u32_f32(mask.v);
+        uint32x2_t folded = vorr_u32(vget_low_u32(m), vget_high_u32(m));
+        return (vget_lane_u32(folded, 0) | vget_lane_u32(folded, 1)) != 0;
+    }
+
+#else
+    float v[4];
+
+    static Float4 load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+    static Float4 splat(float s) { return {{s, s, s, s}}; }
+    static Float4 zero() { return splat(0.0f); }
+    void store(float* p) const { for (int i = 0; i < 4; ++i) p[i] = v[i]; }
+
+    template <typename Op>
+    static Float4 map(Float4 a, Float4 b, Op op) {
+        return {{op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]), op(a.v[3], b.v[3])}};
+    }
+
+    friend Float4 operator+(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return x + y; }); }
+    friend Float4 operator-(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return x - y; }); }
+    friend Float4 operator*(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return x * y; }); }
+    friend Float4 operator/(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return x / y; }); }
+
+    static Float4 min(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return x < y ? x : y; }); }
+    static Float4 max(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return x > y ? x : y; }); }
+    static Float4 sqrt(Float4 a) { return {{std::sqrt(a.v[0]), std::sqrt(a.v[1]), std::sqrt(a.v[2]), std::sqrt(a.v[3])}}; }
+
+    // Scalar fallback stores masks as 1.0f / 0.0f
+    static Float4 lessEqual(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return x <= y ? 1.0f : 0.0f; }); }
+    static Float4 greaterEqual(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return x >= y ? 1.0f : 0.0f; }); }
+    static Float4 maskAnd(Float4 a, Float4 b) { return a * b; }
+    static Float4 select(Float4 mask, Float4 a) { return map(mask, a, [](float m, float x) { return m != 0.0f ? x : 0.0f; }); }
+    static Float4 blend(Float4 mask, Float4 a, Float4 b) {
+        Float4 r;
+        for (int i = 0; i < 4; ++i) r.v[i] = mask.v[i] != 0.0f ? a.v[i] : b.v[i];
+        return r;
+    }
+    static bool any(Float4 mask) { return mask.v[0] != 0.0f || mask.v[1] != 0.0f || mask.v[2] != 0.0f || mask.v[3] != 0.0f; }
+#endif
+};
+
+} // namespace GravityPaint
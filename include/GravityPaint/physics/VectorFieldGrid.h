@@ -0,0 +1,50 @@
+#pragma once
+
+#include "GravityPaint/Types.h"
+#include <vector>
+#include <functional>
+
+namespace GravityPaint {
+
+// Low-resolution 2D grid of force vectors covering the world.
+// Strokes are rasterized into it once, the grid decays (and optionally
+// diffuses) every tick, and objects read it back with bilinear sampling.
+class VectorFieldGrid {
+public:
+    void resize(float width, float height, float cellSize);
+    void clear();
+
+    // Rasterize a stroke: cells within radius of its path receive
+    // direction * strength * falloff, where falloff matches GravityField
+    void splatStroke(const GravityStroke& stroke, float radius);
+
+    // Overwrite every cell with force(cellCenter); used to bake static fields
+    void bake(const std::function<Vec2(const Vec2&)>& force);
+
+    void decay(float deltaTime, float rate);
+    void diffuse(float deltaTime, float rate);
+
+    Vec2 sample(const Vec2& position) const;
+
+    int getColumns() const { return m_columns; }
+    int getRows() const { return m_rows; }
+    float getCellSize() const { return m_cellSize; }
+    bool isEmpty() const { return m_empty; }
+
+private:
+    int index(int column, int row) const { return (row + 1) * m_stride + column + 1; }
+
+    int m_columns = 0;
+    int m_rows = 0;
+    int m_stride = 0;  // Padded row length, multiple of 4 including a zero border
+    float m_cellSize = 1.0f;
+    float m_invCellSize = 1.0f;
+    bool m_empty = true;
+
+    std::vector<float> m_forceX;
+    std::vector<float> m_forceY;
+    std::vector<float> m_scratchX;
+    std::vector<float> m_scratchY;
+};
+
+} // namespace GravityPaint
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "GravityPaint/Types.h"
+#include "GravityPaint/physics/VectorFieldGrid.h"
+#include <box2d/box2d.h>
+#include <vector>
+
+namespace GravityPaint {
+
+// Box2D-side values are kept in Box2D units so a restore is bit-exact
+struct ObjectState {
+    int id = 0;
+    b2Vec2 position;
+    float angle = 0.0f;
+    b2Vec2 linearVelocity;
+    float angularVelocity = 0.0f;
+    Vec2 previousPosition;
+    float previousAngle = 0.0f;
+    float energy = 0.0f;
+    float trailTimer = 0.0f;
+    uint32_t trailOffset = 0;  // Into WorldSnapshot::trails
+    uint32_t trailCount = 0;
+    bool active = true;
+    bool awake = true;
+    bool collected = false;
+    bool reachedGoal = false;
+    bool frozen = false;
+};
+
+struct FieldState {
+    FieldHandle handle;  // Identity check on restore; dense order isn't stable
+    Vec2 position;
+    Vec2 direction;
+    float strength = 0.0f;
+    float radius = 0.0f;
+    float lifetime = 0.0f;
+    float maxLifetime = 0.0f;
+    float pulsePhase = 0.0f;
+    bool active = true;
+};
+
+// Captured by PhysicsWorld::captureSnapshot and applied in place by
+// restoreSnapshot. Buffers are reused across captures, so capturing the
+// same world repeatedly doesn't allocate.
+struct WorldSnapshot {
+    std::vector<ObjectState> objects;
+    std::vector<FieldState> fields;
+    std::vector<Vec2> trails;  // All object trails, back to back
+    VectorFieldGrid paintGrid;
+    float accumulator = 0.0f;
+    uint64_t tick = 0;
+    bool valid = false;
+
+    void clear() {
+        objects.clear();
+        fields.clear();
+        trails.clear();
+        paintGrid.clear();
+        accumulator = 0.0f;
+        tick = 0;
+        valid = false;
+    }
+};
+
+} // namespace GravityPaint
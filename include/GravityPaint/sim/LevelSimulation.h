@@ -0,0 +1,57 @@
+#pragma once
+
+#include "GravityPaint/Types.h"
+#include "GravityPaint/Constants.h"
+#include <cstdint>
+#include <vector>
+
+namespace GravityPaint {
+
+class PhysicsWorld;
+class LevelManager;
+class ReplayRecorder;
+
+// Gameplay that runs on PhysicsWorld's fixed tick: committed strokes are
+// bound and faded before each tick, spawns and objectives advance after
+// it. Shared by the live game, SimulationBatch and ReplayPlayer so all
+// three step a level the same way.
+class LevelSimulation {
+public:
+    LevelSimulation(PhysicsWorld* physics, LevelManager* levelManager);
+    ~LevelSimulation();
+
+    // Resets the world and builds the current level: boundaries, goal,
+    // baked zones and the initial spawns. Loads level 1 if none is loaded.
+    bool setupLevel(GravityMode mode, float paintDiffusion);
+
+    void setStrokeLimit(size_t limit) { m_strokeLimit = limit; }
+    size_t getStrokeLimit() const { return m_strokeLimit; }
+
+    // Queued until the start of the next tick
+    void commitStroke(const GravityStroke& stroke);
+    void clearStrokes();
+    const std::vector<GravityStroke>& getStrokes() const { return m_strokes; }
+
+    // Receives every committed stroke and a per-tick state hash
+    void setRecorder(ReplayRecorder* recorder) { m_recorder = recorder; }
+
+    // Contacts from every tick of the last update(), for effects and audio
+    void update(float deltaTime);
+    const std::vector<ContactEvent>& getContacts() const { return m_contacts; }
+
+private:
+    void preTick(uint64_t tick, float timestep);
+    void postTick(uint64_t tick, float timestep);
+    void onContacts(const std::vector<ContactEvent>& contacts);
+
+    PhysicsWorld* m_physics;
+    LevelManager* m_levelManager;
+    ReplayRecorder* m_recorder = nullptr;
+
+    std::vector<GravityStroke> m_pending;
+    std::vector<GravityStroke> m_strokes;
+    std::vector<ContactEvent> m_contacts;
+    size_t m_strokeLimit = MAX_ACTIVE_STROKES;
+};
+
+} // namespace GravityPaint
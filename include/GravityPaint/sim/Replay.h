@@ -0,0 +1,73 @@
+#pragma once
+
+#include "GravityPaint/Types.h"
+#include "GravityPaint/Constants.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace GravityPaint {
+
+// A stroke as it was bound at the start of a fixed tick
+struct ReplayStroke {
+    uint64_t tick = 0;
+    GravityStroke stroke;
+};
+
+// Everything needed to re-simulate one level attempt bit-exactly on the
+// same build: level, settings, seeds, the stroke timeline and the state
+// hash after every tick.
+struct Replay {
+    int levelId = 1;
+    Difficulty difficulty = Difficulty::Medium;
+    GravityMode gravityMode = GravityMode::Fields;
+    float paintDiffusion = 0.0f;
+    int tickRate = PHYSICS_TICK_RATE;
+    int strokeLimit = MAX_ACTIVE_STROKES;
+    int screenWidth = DEFAULT_SCREEN_WIDTH;
+    int screenHeight = DEFAULT_SCREEN_HEIGHT;
+    uint32_t levelSeed = 0;    // LevelManager::setRandomSeed
+    uint32_t effectsSeed = 0;  // Cosmetic particle RNG
+
+    std::vector<ReplayStroke> strokes;  // Sorted by tick
+    std::vector<uint64_t> tickHashes;   // PhysicsWorld::computeStateHash after tick i
+
+    bool save(const std::string& filepath) const;
+    bool load(const std::string& filepath);
+};
+
+class ReplayRecorder {
+public:
+    // Copies the header fields of `header` and drops any recorded events
+    void begin(const Replay& header);
+    void stop() { m_recording = false; }
+    bool isRecording() const { return m_recording; }
+
+    void recordStroke(uint64_t tick, const GravityStroke& stroke);
+    void recordTick(uint64_t tick, uint64_t stateHash);
+
+    const Replay& getReplay() const { return m_replay; }
+
+private:
+    Replay m_replay;
+    bool m_recording = false;
+};
+
+struct ReplayResult {
+    bool loaded = false;
+    bool matched = true;
+    uint64_t ticks = 0;
+    uint64_t firstMismatchTick = 0;
+    bool completed = false;
+    bool failed = false;
+    double wallSeconds = 0.0;
+};
+
+// Re-simulates a replay headless through the fixed tick and checks every
+// tick hash. Doubles as a repeatable performance workload via wallSeconds.
+class ReplayPlayer {
+public:
+    static ReplayResult play(const Replay& replay);
+};
+
+} // namespace GravityPaint
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "GravityPaint/Types.h"
+#include "GravityPaint/Constants.h"
+#include <cstdint>
+#include <vector>
+
+namespace GravityPaint {
+
+// A stroke committed at a fixed simulation time
+struct ScriptedStroke {
+    float time = 0.0f;
+    GravityStroke stroke;
+};
+
+// One independent world: a level, a difficulty and a stroke timeline
+struct SimulationJob {
+    int levelId = 1;
+    Difficulty difficulty = Difficulty::Medium;
+    GravityMode gravityMode = GravityMode::Fields;
+    std::vector<ScriptedStroke> strokes;  // Sorted by time
+    float maxTime = LEVEL_TIME_LIMIT;
+    int screenWidth = DEFAULT_SCREEN_WIDTH;
+    int screenHeight = DEFAULT_SCREEN_HEIGHT;
+};
+
+struct SimulationResult {
+    bool completed = false;
+    bool failed = false;
+    float time = 0.0f;
+    int ticks = 0;
+    uint64_t stateHash = 0;  // PhysicsWorld::computeStateHash() of the final state
+};
+
+struct SimulationBatchStats {
+    int threadCount = 0;
+    uint64_t totalTicks = 0;
+    double wallSeconds = 0.0;
+    double worldTicksPerSecond = 0.0;
+};
+
+// Runs many independent PhysicsWorld + Level instances on a pool of worker
+// threads. No Game, SDL or rendering involved; each job owns its own world.
+class SimulationBatch {
+public:
+    explicit SimulationBatch(int threadCount = 0);  // 0 = one per hardware thread
+
+    size_t addJob(const SimulationJob& job);
+    void clearJobs();
+    size_t getJobCount() const { return m_jobs.size(); }
+
+    // Blocks until every job has finished
+    void run();
+
+    const std::vector<SimulationResult>& getResults() const { return m_results; }
+    const SimulationBatchStats& getStats() const { return m_stats; }
+
+    // Simulates a single job on the calling thread at PHYSICS_TICK_RATE
+    static SimulationResult runJob(const SimulationJob& job);
+
+    // Builds a committed swipe the same way PlayingState does for player input
+    static GravityStroke makeSwipe(const Vec2& start, const Vec2& end, int samples = 8);
+
+private:
+    int m_threadCount;
+    std::vector<SimulationJob> m_jobs;
+    std::vector<SimulationResult> m_results;
+    SimulationBatchStats m_stats;
+};
+
+} // namespace GravityPaint
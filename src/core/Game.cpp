@@ -33,6 +33,14 @@ bool Game::initialize(int screenWidth, int screenHeight) {
         return false;
     }
 
+    // The working directory may be read-only or shared (app bundles, mobile)
+    if (char* prefPath = SDL_GetPrefPath("GravityPaint", "GravityPaint")) {
+        m_prefPath = prefPath;
+        SDL_free(prefPath);
+    } else {
+        SDL_Log("No preference path, saving to the working directory: %s", SDL_GetError());
+    }
+
     // Create window
     uint32_t windowFlags = SDL_WINDOW_SHOWN;
 #if defined(GRAVITYPAINT_ANDROID) || defined(GRAVITYPAINT_IOS)
@@ -252,8 +260,8 @@ void Game::calculateDeltaTime() {
     m_lastFrameTime = currentTime;
 
     // Clamp delta time to avoid physics explosions
-    if (m_deltaTime > 0.1f) {
-        m_deltaTime = 0.1f;
+    if (m_deltaTime > MAX_FRAME_DELTA) {
+        m_deltaTime = MAX_FRAME_DELTA;
     }
 }
 
@@ -1,8 +1,11 @@
 #include "GravityPaint/core/GameState.h"
 #include "GravityPaint/core/Game.h"
 #include "GravityPaint/core/InputManager.h"
+#include "GravityPaint/core/SimulationThread.h"
+#include "GravityPaint/sim/Replay.h"
 #include "GravityPaint/physics/PhysicsWorld.h"
 #include "GravityPaint/physics/PhysicsObject.h"
+#include "GravityPaint/physics/WorldSnapshot.h"
 #include "GravityPaint/graphics/Renderer.h"
 #include "GravityPaint/audio/AudioManager.h"
 #include "GravityPaint/level/LevelManager.h"
@@ -134,9 +137,14 @@ void MenuState::handleInput(const TouchPoint& touch) {
 // PlayingState
 PlayingState::PlayingState(Game* game) : GameState(game) {}
 
+PlayingState::~PlayingState() = default;
+
 void PlayingState::enter() {
+    m_snapshot = nullptr;
+    m_contactTick = 0;
     m_gravityStrokes.clear();
     m_particles.clear();
+    m_celebratedObjects.clear();
     m_isDrawingStroke = false;
     m_levelTime = 0.0f;
     m_levelComplete = false;
@@ -156,24 +164,47 @@ void PlayingState::enter() {
     }
     
     hud->clearButtons();
-    physics->reset();
 
-    if (!levelManager->getCurrentLevel()) {
-        levelManager->loadLevel(1);
-    }
+    m_simulation = std::make_unique<SimulationThread>(physics, levelManager);
+    LevelSimulation& simulation = m_simulation->getLevelSimulation();
 
-    levelManager->startLevel();
+    // Zen and Endless paint gravity into a grid, which lifts the stroke cap
+    GameMode mode = m_game->getGameMode();
+    bool painted = mode == GameMode::Zen || mode == GameMode::Endless;
+    GravityMode gravityMode = painted ? GravityMode::Paint : GravityMode::Fields;
+    float paintDiffusion = mode == GameMode::Zen ? PAINT_FIELD_DIFFUSION_RATE : 0.0f;
 
-    auto* level = levelManager->getCurrentLevel();
-    if (!level) {
+    if (!simulation.setupLevel(gravityMode, paintDiffusion)) {
         return;
     }
-    
-    physics->createBoundaries(level->getWidth(), level->getHeight());
-    physics->createGoalZone(level->getGoalZone().center(), 
-                           Vec2(level->getGoalZone().w, level->getGoalZone().h));
+    simulation.setStrokeLimit(getStrokeLimit());
 
-    levelManager->spawnObjects(physics);
+    auto* level = levelManager->getCurrentLevel();
+
+    m_startSnapshot = std::make_unique<WorldSnapshot>();
+    physics->captureSnapshot(*m_startSnapshot);
+
+    // Every attempt is recorded so bug reports can be replayed
+    m_replayHeader = Replay();
+    m_replayHeader.levelId = level->getId();
+    m_replayHeader.difficulty = levelManager->getGameDifficulty();
+    m_replayHeader.gravityMode = gravityMode;
+    m_replayHeader.paintDiffusion = paintDiffusion;
+    m_replayHeader.tickRate = physics->getTickRate();
+    m_replayHeader.strokeLimit = static_cast<int>(getStrokeLimit());
+    m_replayHeader.screenWidth = m_game->getScreenWidth();
+    m_replayHeader.screenHeight = m_game->getScreenHeight();
+    m_replayHeader.levelSeed = levelManager->getRandomSeed();
+    m_replayHeader.effectsSeed = std::random_device{}();
+    m_effectsRng.seed(m_replayHeader.effectsSeed);
+
+    m_recorder = std::make_unique<ReplayRecorder>();
+    m_recorder->begin(m_replayHeader);
+    simulation.setRecorder(m_recorder.get());
+
+    // From here on the simulation thread owns physics and level state
+    m_simulation->start();
+    m_snapshot = &m_simulation->acquireSnapshot();
 
     hud->setLevelNumber(level->getId());
     hud->setTimeLimit(level->getTimeLimit());
@@ -188,73 +219,73 @@ void PlayingState::enter() {
     hud->addButton(
         Rect(m_game->getScreenWidth() - 120, 50, 110, 40),
         "RESTART",
-        [game]() { 
-            game->restartLevel();
+        [this, game]() { 
+            game->resetScore();
+            if (!restartFromSnapshot()) {
+                game->restartLevel();
+            }
         }
     );
 }
 
 void PlayingState::exit() {
+    if (m_simulation) {
+        m_simulation->stop();
+    }
+    if (m_recorder && m_recorder->isRecording()) {
+        std::string path = m_game->getSavePath("gravitypaint_last.replay");
+        if (!m_recorder->getReplay().save(path)) {
+            SDL_Log("Failed to save replay: %s", path.c_str());
+        }
+        m_recorder->stop();
+    }
     m_game->getHUD()->clearButtons();
     m_game->getHUD()->setPauseButtonVisible(false);
 }
 
 void PlayingState::update(float deltaTime) {
-    if (m_levelComplete) return;
+    if (m_levelComplete || !m_simulation) return;
 
     m_levelTime += deltaTime;
     
-    auto* physics = m_game->getPhysicsWorld();
-    auto* levelManager = m_game->getLevelManager();
     auto* hud = m_game->getHUD();
 
-    // Update gravity strokes
-    updateGravityStrokes(deltaTime);
+    // Steps inline on builds without threads, otherwise a no-op
+    m_simulation->update(deltaTime);
 
-    // Apply gravity from strokes to physics
-    physics->applyGravityFromStrokes(m_gravityStrokes);
-
-    // Update physics
-    physics->update(deltaTime);
-
-    // Update spawns
-    levelManager->updateSpawns(deltaTime, physics);
-    levelManager->updateLevel(deltaTime);
-    
-    // Update objective progress
-    levelManager->updateObjectiveProgress(physics);
+    // Render draws from the same snapshot, so a frame is never torn
+    m_snapshot = &m_simulation->acquireSnapshot();
+    const RenderSnapshot& snapshot = *m_snapshot;
+    m_gravityStrokes = snapshot.strokes;
     
     // Update particles
     updateParticles(deltaTime);
     
     // Check for objects reaching goal and spawn particles
-    auto* level = levelManager->getCurrentLevel();
-    if (level) {
-        static std::vector<int> celebratedObjects;
-        for (const auto& obj : physics->getObjects()) {
-            if (obj && obj->isActive() && obj->hasReachedGoal()) {
-                // Spawn celebration particles when object first reaches goal
-                if (std::find(celebratedObjects.begin(), celebratedObjects.end(), obj->getId()) == celebratedObjects.end()) {
-                    spawnGoalParticles(obj->getPosition(), obj->getColor());
-                    celebratedObjects.push_back(obj->getId());
-                    if (celebratedObjects.size() > 100) celebratedObjects.erase(celebratedObjects.begin());
-                }
+    for (const auto& obj : snapshot.objects) {
+        if (obj.active && obj.reachedGoal) {
+            // Spawn celebration particles when object first reaches goal
+            if (std::find(m_celebratedObjects.begin(), m_celebratedObjects.end(), obj.id) == m_celebratedObjects.end()) {
+                spawnGoalParticles(obj.position, obj.color);
+                m_celebratedObjects.push_back(obj.id);
+                if (m_celebratedObjects.size() > 100) m_celebratedObjects.erase(m_celebratedObjects.begin());
             }
         }
     }
 
+    // Collision effects, each contact once
+    playContactEffects(snapshot);
+
     // Update HUD
     hud->setLevelTime(m_levelTime);
-    hud->setProgress(levelManager->getCurrentLevel()->getObjective() 
-                     ? levelManager->getCurrentLevel()->getObjective()->getProgress() : 0.0f);
+    hud->setProgress(snapshot.objectiveProgress);
 
     // Check for level completion
-    checkLevelCompletion();
+    checkLevelCompletion(snapshot);
 }
 
 void PlayingState::render() {
     auto* renderer = m_game->getRenderer();
-    auto* physics = m_game->getPhysicsWorld();
     auto* level = m_game->getLevelManager()->getCurrentLevel();
 
     // Draw gradient background
@@ -269,10 +300,35 @@ void PlayingState::render() {
     // Draw background grid
     renderer->drawGrid(50.0f, Color(50, 50, 80, 100));
 
+    // Draw gravity zones
+    if (level) {
+        for (const auto& zone : level->getGravityZones()) {
+            Color zoneColor = zone.color;
+            zoneColor.a = 60;
+            Rect bounds(zone.position.x - zone.size.x / 2, zone.position.y - zone.size.y / 2,
+                        zone.size.x, zone.size.y);
+            renderer->drawRect(bounds, zoneColor, true);
+        }
+    }
+
     // Draw goal zone
     if (level) {
-        Rect goal = level->getGoalZone();
-        renderer->drawGoalZone(goal);
+        for (const auto& goal : level->getGoalZones()) {
+            renderer->drawGoalZone(goal);
+        }
+    }
+
+    // Draw obstacles; moving ones take their position from the snapshot
+    if (level && m_snapshot) {
+        const auto& movers = m_snapshot->movers;
+        size_t mover = 0;
+        for (const auto& obstacle : level->getObstacles()) {
+            Vec2 position = obstacle.position;
+            if (obstacle.isMoving && mover < movers.size()) {
+                position = movers[mover++];
+            }
+            renderer->drawObstacle(obstacle, position);
+        }
     }
 
     // Draw gravity strokes
@@ -285,9 +341,11 @@ void PlayingState::render() {
         renderer->drawGravityStroke(m_currentStroke);
     }
 
-    // Draw physics objects
-    for (const auto& obj : physics->getObjects()) {
-        renderer->drawPhysicsObject(obj.get());
+    // Draw physics objects from the snapshot update() acquired
+    if (m_snapshot) {
+        for (const auto& obj : m_snapshot->objects) {
+            renderer->drawObjectSnapshot(obj);
+        }
     }
     
     // Draw particles
@@ -346,18 +404,15 @@ void PlayingState::handleInput(const TouchPoint& touch) {
                 m_currentStroke.maxLifetime = GRAVITY_STROKE_LIFETIME;
                 m_currentStroke.isActive = true;
 
-                // Limit active strokes
-                if (m_gravityStrokes.size() >= MAX_ACTIVE_STROKES) {
-                    m_gravityStrokes.erase(m_gravityStrokes.begin());
-                }
-
-                m_gravityStrokes.push_back(m_currentStroke);
-                m_game->getHUD()->setStrokeCount(
-                    static_cast<int>(m_gravityStrokes.size()),
-                    m_game->getLevelManager()->getCurrentLevel()->getMaxStrokes()
-                );
+                // The simulation thread binds the field and enforces the stroke limit
+                if (m_simulation && m_simulation->submitStroke(m_currentStroke)) {
+                    m_game->getHUD()->setStrokeCount(
+                        static_cast<int>(std::min(m_gravityStrokes.size() + 1, getStrokeLimit())),
+                        m_game->getLevelManager()->getCurrentLevel()->getMaxStrokes()
+                    );
 
-                m_game->getAudioManager()->playSound(SoundEffect::GravitySwipe);
+                    m_game->getAudioManager()->playSound(SoundEffect::GravitySwipe);
+                }
             }
         }
 
@@ -366,31 +421,63 @@ void PlayingState::handleInput(const TouchPoint& touch) {
 }
 
 void PlayingState::addGravityStroke(const GravityStroke& stroke) {
-    if (m_gravityStrokes.size() >= MAX_ACTIVE_STROKES) {
-        m_gravityStrokes.erase(m_gravityStrokes.begin());
+    if (m_simulation) {
+        m_simulation->submitStroke(stroke);
     }
-    m_gravityStrokes.push_back(stroke);
 }
 
-void PlayingState::updateGravityStrokes(float deltaTime) {
-    for (auto it = m_gravityStrokes.begin(); it != m_gravityStrokes.end();) {
-        it->lifetime += deltaTime;
-        if (it->lifetime >= it->maxLifetime) {
-            it = m_gravityStrokes.erase(it);
-        } else {
-            ++it;
-        }
+bool PlayingState::restartFromSnapshot() {
+    if (!m_simulation || !m_startSnapshot) return false;
+
+    auto* physics = m_game->getPhysicsWorld();
+    auto* levelManager = m_game->getLevelManager();
+
+    m_simulation->stop();
+    m_simulation->clearStrokes();
+
+    // Fresh objective and spawn timers; the level layout is deterministic
+    levelManager->reloadCurrentLevel();
+    levelManager->startLevel();
+    if (!physics->restoreSnapshot(*m_startSnapshot)) {
+        return false;
     }
+    levelManager->markInitialSpawns();
+
+    if (m_recorder) {
+        m_recorder->begin(m_replayHeader);
+    }
+
+    m_gravityStrokes.clear();
+    m_particles.clear();
+    m_celebratedObjects.clear();
+    m_isDrawingStroke = false;
+    m_levelTime = 0.0f;
+    m_levelComplete = false;
+    m_contactTick = 0;
+
+    auto* level = levelManager->getCurrentLevel();
+    m_game->getHUD()->setStrokeCount(0, level ? level->getMaxStrokes() : 0);
+
+    m_simulation->start();
+    m_snapshot = &m_simulation->acquireSnapshot();
+    return true;
 }
 
-void PlayingState::checkLevelCompletion() {
-    auto* physics = m_game->getPhysicsWorld();
+size_t PlayingState::getStrokeLimit() const {
+    if (m_game->getPhysicsWorld()->getGravityMode() == GravityMode::Paint) {
+        return MAX_PAINT_STROKES;
+    }
+    return MAX_ACTIVE_STROKES;
+}
+
+void PlayingState::checkLevelCompletion(const RenderSnapshot& snapshot) {
     auto* level = m_game->getLevelManager()->getCurrentLevel();
     
     if (!level || !level->getObjective()) return;
 
-    if (level->getObjective()->isComplete() && !m_levelComplete) {
+    if (snapshot.objectiveComplete && !m_levelComplete) {
         m_levelComplete = true;
+        m_simulation->stop();
         SDL_Log("LEVEL COMPLETE! Changing state...");
         
         // Calculate score
@@ -403,19 +490,18 @@ void PlayingState::checkLevelCompletion() {
         m_game->addScore(BASE_GOAL_SCORE + timeBonus + strokeBonus);
         m_game->getLevelManager()->completeLevel(m_game->getScore(), m_levelTime);
         m_game->changeState(GameStateType::LevelComplete);
-    } else if (level->getObjective()->isFailed()) {
+    } else if (snapshot.objectiveFailed) {
+        m_simulation->stop();
+
         // Lose a life but continue if lives remain
         m_game->loseLife();
         if (m_game->getLives() > 0) {
             // Reset level and continue playing
             m_game->getHUD()->showMessage("Try Again!", 1.5f);
-            m_game->getLevelManager()->reloadCurrentLevel();
-            m_game->getPhysicsWorld()->reset();
-            m_game->getLevelManager()->startLevel();
-            m_game->getLevelManager()->spawnObjects(m_game->getPhysicsWorld());
             m_game->getHUD()->setLives(m_game->getLives(), m_game->getMaxLives());
-            m_levelTime = 0.0f;
-            m_gravityStrokes.clear();
+            if (!restartFromSnapshot()) {
+                m_game->changeState(GameStateType::Playing);
+            }
         }
         // If lives == 0, loseLife() already changed state to GameOver
     }
@@ -440,32 +526,60 @@ void PlayingState::updateParticles(float deltaTime) {
     );
 }
 
+float PlayingState::randomUnit() {
+    return std::uniform_real_distribution<float>(0.0f, 1.0f)(m_effectsRng);
+}
+
 void PlayingState::spawnGoalParticles(const Vec2& position, const Color& color) {
     for (int i = 0; i < 20; ++i) {
         SimpleParticle p;
         p.position = position;
-        float angle = (static_cast<float>(rand()) / RAND_MAX) * 6.28318f;
-        float speed = 100.0f + (static_cast<float>(rand()) / RAND_MAX) * 200.0f;
+        float angle = randomUnit() * 6.28318f;
+        float speed = 100.0f + randomUnit() * 200.0f;
         p.velocity = Vec2(std::cos(angle) * speed, std::sin(angle) * speed - 150.0f);
         p.color = color;
-        p.size = 4.0f + (static_cast<float>(rand()) / RAND_MAX) * 8.0f;
-        p.life = 0.5f + (static_cast<float>(rand()) / RAND_MAX) * 0.5f;
+        p.size = 4.0f + randomUnit() * 8.0f;
+        p.life = 0.5f + randomUnit() * 0.5f;
         p.maxLife = p.life;
-        p.rotationSpeed = (static_cast<float>(rand()) / RAND_MAX - 0.5f) * 10.0f;
+        p.rotationSpeed = (randomUnit() - 0.5f) * 10.0f;
         m_particles.push_back(p);
     }
 }
 
+void PlayingState::playContactEffects(const RenderSnapshot& snapshot) {
+    bool impact = false;
+    for (const auto& contact : snapshot.contacts) {
+        if (!contact.began || contact.tick < m_contactTick) continue;
+
+        Color color(255, 255, 255);
+        for (const auto& obj : snapshot.objects) {
+            if (obj.id == contact.idA) {
+                color = obj.color;
+                break;
+            }
+        }
+        spawnCollisionParticles(contact.point, color);
+        impact = true;
+    }
+
+    m_contactTick = std::max(m_contactTick, snapshot.tick);
+
+    // One sound per batch; a pile-up shouldn't stack dozens of channels
+    if (impact) {
+        m_game->getAudioManager()->playSound(SoundEffect::Collision);
+    }
+}
+
 void PlayingState::spawnCollisionParticles(const Vec2& position, const Color& color) {
     for (int i = 0; i < 8; ++i) {
         SimpleParticle p;
         p.position = position;
-        float angle = (static_cast<float>(rand()) / RAND_MAX) * 6.28318f;
-        float speed = 50.0f + (static_cast<float>(rand()) / RAND_MAX) * 100.0f;
+        float angle = randomUnit() * 6.28318f;
+        float speed = 50.0f + randomUnit() * 100.0f;
         p.velocity = Vec2(std::cos(angle) * speed, std::sin(angle) * speed);
         p.color = color;
-        p.size = 2.0f + (static_cast<float>(rand()) / RAND_MAX) * 4.0f;
-        p.life = 0.2f + (static_cast<float>(rand()) / RAND_MAX) * 0.3f;
+        p.size = 2.0f + randomUnit() * 4.0f;
+        p.life = 0.2f + randomUnit() * 0.3f;
         p.maxLife = p.life;
         m_particles.push_back(p);
     }
@@ -0,0 +1,159 @@
+#include "GravityPaint/core/SimulationThread.h"
+#include "GravityPaint/physics/PhysicsWorld.h"
+#include "GravityPaint/physics/PhysicsObject.h"
+#include "GravityPaint/level/LevelManager.h"
+#include "GravityPaint/level/Level.h"
+#include "GravityPaint/level/Objective.h"
+#include <algorithm>
+#include <chrono>
+
+namespace GravityPaint {
+
+SimulationThread::SimulationThread(PhysicsWorld* physics, LevelManager* levelManager)
+    : m_physics(physics)
+    , m_levelManager(levelManager)
+    , m_level(physics, levelManager)
+{
+    m_pendingContacts.reserve(MAX_PENDING_CONTACTS);
+}
+
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+bool SimulationThread::isThreaded() const {
+#ifdef __EMSCRIPTEN__
+    return false;
+#else
+    return true;
+#endif
+}
+
+void SimulationThread::start() {
+    if (m_running) return;
+
+    // Contacts from before a restart belong to the old timeline
+    m_pendingContacts.clear();
+    m_consumedTick.store(0, std::memory_order_relaxed);
+
+    // Make sure the first acquireSnapshot() sees the freshly set up level
+    publish();
+
+    m_running = true;
+    if (isThreaded()) {
+        m_thread = std::thread(&SimulationThread::threadMain, this);
+    }
+}
+
+void SimulationThread::stop() {
+    m_running = false;
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+bool SimulationThread::submitStroke(const GravityStroke& stroke) {
+    return m_strokeQueue.push(stroke);
+}
+
+void SimulationThread::clearStrokes() {
+    GravityStroke pending;
+    while (m_strokeQueue.pop(pending)) {}
+
+    m_level.clearStrokes();
+}
+
+void SimulationThread::update(float deltaTime) {
+    if (!m_running || isThreaded()) return;
+    step(deltaTime);
+    publish();
+}
+
+const RenderSnapshot& SimulationThread::acquireSnapshot() {
+    if (m_middle.load(std::memory_order_acquire) & FRESH_BIT) {
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & ~FRESH_BIT;
+        m_consumedTick.store(m_buffers[m_front].tick, std::memory_order_release);
+    }
+    return m_buffers[m_front];
+}
+
+void SimulationThread::threadMain() {
+    using Clock = std::chrono::steady_clock;
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<float>(TARGET_FRAME_TIME));
+
+    auto last = Clock::now();
+    while (m_running) {
+        auto now = Clock::now();
+        float deltaTime = std::chrono::duration<float>(now - last).count();
+        last = now;
+
+        step(deltaTime);
+        publish();
+
+        std::this_thread::sleep_until(now + period);
+    }
+}
+
+void SimulationThread::step(float deltaTime) {
+    // Strokes are bound at the next tick boundary, see LevelSimulation
+    GravityStroke incoming;
+    while (m_strokeQueue.pop(incoming)) {
+        m_level.commitStroke(incoming);
+    }
+
+    // PhysicsWorld clamps the raw delta itself so dropped time is counted
+    m_level.update(deltaTime);
+
+    const auto& contacts = m_level.getContacts();
+    m_pendingContacts.insert(m_pendingContacts.end(), contacts.begin(), contacts.end());
+    if (m_pendingContacts.size() > MAX_PENDING_CONTACTS) {
+        m_pendingContacts.erase(m_pendingContacts.begin(),
+                                m_pendingContacts.end() - MAX_PENDING_CONTACTS);
+    }
+
+    ++m_step;
+}
+
+void SimulationThread::publish() {
+    RenderSnapshot& snapshot = m_buffers[m_back];
+
+    // Reuse the slot's vectors so steady-state publishing does not allocate
+    const auto& objects = m_physics->getObjects();
+    float alpha = m_physics->getInterpolationAlpha();
+    snapshot.objects.resize(objects.size());
+    for (size_t i = 0; i < objects.size(); ++i) {
+        objects[i].fillSnapshot(snapshot.objects[i], alpha);
+    }
+
+    const auto& strokes = m_level.getStrokes();
+    snapshot.strokes.assign(strokes.begin(), strokes.end());
+    for (auto& stroke : snapshot.strokes) {
+        stroke.field = FieldHandle();
+    }
+
+    // Drop what the reader has seen; contacts are in tick order
+    uint64_t consumed = m_consumedTick.load(std::memory_order_acquire);
+    auto unseen = std::find_if(m_pendingContacts.begin(), m_pendingContacts.end(),
+                               [consumed](const ContactEvent& contact) { return contact.tick >= consumed; });
+    m_pendingContacts.erase(m_pendingContacts.begin(), unseen);
+    snapshot.contacts.assign(m_pendingContacts.begin(), m_pendingContacts.end());
+
+    snapshot.movers.resize(m_physics->getMovingObstacleCount());
+    for (size_t i = 0; i < snapshot.movers.size(); ++i) {
+        snapshot.movers[i] = m_physics->getMovingObstaclePosition(i, alpha);
+    }
+
+    Level* level = m_levelManager->getCurrentLevel();
+    Objective* objective = level ? level->getObjective() : nullptr;
+    snapshot.objectiveProgress = objective ? objective->getProgress() : 0.0f;
+    snapshot.objectiveComplete = objective && objective->isComplete();
+    snapshot.objectiveFailed = objective && objective->isFailed();
+    snapshot.step = m_step;
+    snapshot.tick = m_physics->getTick();
+    snapshot.stepStats = m_physics->getStepStats();
+
+    m_back = m_middle.exchange(m_back | FRESH_BIT, std::memory_order_acq_rel) & ~FRESH_BIT;
+}
+
+} // namespace GravityPaint
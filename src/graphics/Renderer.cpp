@@ -3,6 +3,7 @@
 #include "GravityPaint/physics/PhysicsObject.h"
 #include "GravityPaint/physics/GravityField.h"
 #include "GravityPaint/physics/DeformableSurface.h"
+#include "GravityPaint/level/Level.h"
 #include "GravityPaint/Constants.h"
 #include <cmath>
 #include <random>
@@ -295,27 +296,35 @@ void Renderer::drawDashedLine(const Vec2& start, const Vec2& end, const Color& c
     }
 }
 
-void Renderer::drawPhysicsObject(const PhysicsObject* object) {
+void Renderer::drawPhysicsObject(const PhysicsObject* object, float alpha) {
     if (!object || !object->isActive()) return;
 
-    Vec2 pos = object->getPosition();
-    float size = object->getSize() * 20.0f;
-    float angle = object->getAngle();
-    Color color = object->getColor();
+    ObjectSnapshot snapshot;
+    object->fillSnapshot(snapshot, alpha);
+    drawObjectSnapshot(snapshot);
+}
+
+void Renderer::drawObjectSnapshot(const ObjectSnapshot& object) {
+    if (!object.active) return;
+
+    Vec2 pos = object.position;
+    float size = object.size * 20.0f;
+    float angle = object.angle;
+    Color color = object.color;
 
     // Draw trail first (behind object)
-    drawTrail(object->getTrail(), Color(color.r, color.g, color.b, 100));
+    drawTrail(object.trail, Color(color.r, color.g, color.b, 100));
 
     // Draw energy glow
-    float energyRatio = object->getEnergy() / MAX_OBJECT_ENERGY;
+    float energyRatio = object.energy / MAX_OBJECT_ENERGY;
     if (energyRatio > 0.3f) {
-        Color glowColor = object->getEnergyColor();
+        Color glowColor = object.energyColor;
         glowColor.a = static_cast<uint8_t>(energyRatio * 100);
         drawCircle(pos, size * 1.5f, glowColor, true);
     }
 
     // Draw object based on type
-    switch (object->getType()) {
+    switch (object.type) {
         case ObjectType::Ball:
         case ObjectType::Blob:
             drawCircle(pos, size, color, true);
@@ -363,7 +372,7 @@ void Renderer::drawPhysicsObject(const PhysicsObject* object) {
     }
 
     // Draw small energy indicator
-    drawEnergyBar(pos + Vec2(0, -size - 10), object->getEnergy(), MAX_OBJECT_ENERGY);
+    drawEnergyBar(pos + Vec2(0, -size - 10), object.energy, MAX_OBJECT_ENERGY);
 }
 
 void Renderer::drawGravityField(const GravityField* field) {
@@ -420,21 +429,19 @@ void Renderer::drawGravityStroke(const GravityStroke& stroke) {
 void Renderer::drawDeformableSurface(const DeformableSurface* surface) {
     if (!surface) return;
 
-    const auto& nodes = surface->getNodes();
-    const auto& springs = surface->getSprings();
     Color color = surface->getColor();
 
     // Draw springs
-    for (const auto& spring : springs) {
-        Vec2 posA = nodes[spring.nodeA].position;
-        Vec2 posB = nodes[spring.nodeB].position;
+    for (size_t i = 0; i < surface->getSpringCount(); ++i) {
+        Vec2 posA = surface->getNodePosition(surface->getSpringNodeA(i));
+        Vec2 posB = surface->getNodePosition(surface->getSpringNodeB(i));
         drawLine(posA, posB, color, 2.0f);
     }
 
     // Draw nodes
-    for (const auto& node : nodes) {
-        Color nodeColor = node.isFixed ? Color::red() : color;
-        drawCircle(node.position, 4.0f, nodeColor, true);
+    for (size_t i = 0; i < surface->getNodeCount(); ++i) {
+        Color nodeColor = surface->isNodeFixed(i) ? Color::red() : color;
+        drawCircle(surface->getNodePosition(i), 4.0f, nodeColor, true);
     }
 }
 
@@ -459,6 +466,33 @@ void Renderer::drawGoalZone(const Rect& zone) {
     drawRect(innerZone, Color(100, 255, 100, 80), false);
 }
 
+void Renderer::drawObstacle(const ObstacleData& obstacle, const Vec2& position) {
+    Color edge = Color::lerp(obstacle.color, Color::white(), 0.3f);
+
+    if (obstacle.isCircle) {
+        float radius = obstacle.size.x / 2;
+        drawCircle(position, radius, obstacle.color, true);
+        drawCircle(position, radius, edge, false);
+        return;
+    }
+
+    // Same corner order and rotation sense as the Box2D box
+    float c = std::cos(obstacle.rotation);
+    float s = std::sin(obstacle.rotation);
+    float hx = obstacle.size.x / 2;
+    float hy = obstacle.size.y / 2;
+
+    const Vec2 local[4] = {Vec2(-hx, -hy), Vec2(hx, -hy), Vec2(hx, hy), Vec2(-hx, hy)};
+    std::vector<Vec2> corners;
+    corners.reserve(4);
+    for (const Vec2& p : local) {
+        corners.emplace_back(position.x + c * p.x - s * p.y, position.y + s * p.x + c * p.y);
+    }
+
+    drawPolygon(corners, obstacle.color, true);
+    drawPolygon(corners, edge, false);
+}
+
 void Renderer::drawTrail(const std::vector<Vec2>& trail, const Color& color) {
     if (trail.size() < 2) return;
 
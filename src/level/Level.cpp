@@ -2,7 +2,7 @@
 #include "GravityPaint/Constants.h"
 #include <fstream>
 #include <sstream>
-#include <SDL.h>
+#include <cstdio>
 
 namespace GravityPaint {
 
@@ -15,7 +15,7 @@ Level::Level()
 bool Level::load(const std::string& filepath) {
     std::ifstream file(filepath);
     if (!file.is_open()) {
-        SDL_Log("Failed to open level file: %s", filepath.c_str());
+        std::fprintf(stderr, "Failed to open level file: %s\n", filepath.c_str());
         return false;
     }
 
@@ -11,7 +11,14 @@ namespace GravityPaint {
 
 const LevelProgress LevelManager::s_emptyProgress;
 
-LevelManager::LevelManager() = default;
+LevelManager::LevelManager() {
+    setRandomSeed(std::random_device{}());
+}
+
+void LevelManager::setRandomSeed(uint32_t seed) {
+    m_randomSeed = seed;
+    m_rng.seed(seed);
+}
 
 LevelManager::~LevelManager() {
     shutdown();
@@ -218,39 +225,33 @@ bool LevelManager::isLevelUnlocked(int levelId) const {
 }
 
 void LevelManager::spawnObjects(PhysicsWorld* physics) {
-    static std::ofstream logFile("GRAVITYPAINT_spawn.log", std::ios::app);
-    logFile << "spawnObjects called" << std::endl;
-    
-    if (!m_currentLevel) { logFile << "ERROR: m_currentLevel is null" << std::endl; return; }
-    if (!physics) { logFile << "ERROR: physics is null" << std::endl; return; }
+    if (!m_currentLevel || !physics) return;
 
     const auto& spawnPoints = m_currentLevel->getSpawnPoints();
-    logFile << "spawnPoints count: " << spawnPoints.size() << std::endl;
-    logFile << "m_spawnedObjects size: " << m_spawnedObjects.size() << std::endl;
-    logFile.flush();
-    
     for (size_t i = 0; i < spawnPoints.size(); ++i) {
-        logFile << "Processing spawn " << i << std::endl;
-        logFile.flush();
-        
         const SpawnPoint& spawn = spawnPoints[i];
-        
+
         if (spawn.delay <= 0 && !m_spawnedObjects[i]) {
-            logFile << "Creating object at " << spawn.position.x << "," << spawn.position.y << std::endl;
-            logFile.flush();
-            
-            PhysicsObject* obj = physics->createObject(spawn.objectType, spawn.position, spawn.size);
+            PhysicsObject* obj = physics->getObject(
+                physics->createObject(spawn.objectType, spawn.position, spawn.size));
             if (obj) {
                 obj->setEnergy(spawn.energy);
                 obj->setColor(spawn.color);
             }
             m_spawnedObjects[i] = 1;
-            logFile << "Object created" << std::endl;
-            logFile.flush();
         }
     }
-    logFile << "spawnObjects done" << std::endl;
-    logFile.flush();
+}
+
+void LevelManager::markInitialSpawns() {
+    if (!m_currentLevel) return;
+
+    const auto& spawnPoints = m_currentLevel->getSpawnPoints();
+    for (size_t i = 0; i < spawnPoints.size(); ++i) {
+        if (spawnPoints[i].delay <= 0) {
+            m_spawnedObjects[i] = 1;
+        }
+    }
 }
 
 void LevelManager::updateSpawns(float deltaTime, PhysicsWorld* physics) {
@@ -267,7 +268,8 @@ void LevelManager::updateSpawns(float deltaTime, PhysicsWorld* physics) {
         const SpawnPoint& spawn = spawnPoints[i];
         
         if (m_spawnTimer >= spawn.delay) {
-            PhysicsObject* obj = physics->createObject(spawn.objectType, spawn.position, spawn.size);
+            PhysicsObject* obj = physics->getObject(
+                physics->createObject(spawn.objectType, spawn.position, spawn.size));
             if (obj) {
                 obj->setEnergy(spawn.energy);
                 obj->setColor(spawn.color);
@@ -284,7 +286,6 @@ void LevelManager::updateSpawns(float deltaTime, PhysicsWorld* physics) {
 std::unique_ptr<Level> LevelManager::generateProceduralLevel(int difficulty) {
     auto level = std::make_unique<Level>();
     
-    std::mt19937 rng(std::random_device{}());
     std::uniform_real_distribution<float> distX(100, DEFAULT_SCREEN_WIDTH - 100);
     std::uniform_real_distribution<float> distY(100, DEFAULT_SCREEN_HEIGHT / 2);
 
@@ -300,7 +301,7 @@ std::unique_ptr<Level> LevelManager::generateProceduralLevel(int difficulty) {
     int objectCount = 1 + difficulty / 2;
     for (int i = 0; i < objectCount; ++i) {
         SpawnPoint spawn;
-        spawn.position = Vec2(distX(rng), distY(rng));
+        spawn.position = Vec2(distX(m_rng), distY(m_rng));
         spawn.objectType = static_cast<ObjectType>(i % 5);
         spawn.delay = i * 1.5f;
         spawn.size = 1.0f;
@@ -313,7 +314,7 @@ std::unique_ptr<Level> LevelManager::generateProceduralLevel(int difficulty) {
     int obstacleCount = difficulty / 3;
     for (int i = 0; i < obstacleCount; ++i) {
         ObstacleData obstacle;
-        obstacle.position = Vec2(distX(rng), DEFAULT_SCREEN_HEIGHT / 2 + distY(rng) / 2);
+        obstacle.position = Vec2(distX(m_rng), DEFAULT_SCREEN_HEIGHT / 2 + distY(m_rng) / 2);
         obstacle.size = Vec2(100, 20);
         obstacle.isCircle = (i % 2 == 0);
         level->addObstacle(obstacle);
@@ -499,4 +500,10 @@ void LevelManager::updateObjectiveProgress(PhysicsWorld* physics) {
     m_currentLevel->getObjective()->update(0, physics);
 }
 
+void LevelManager::recordContacts(const std::vector<ContactEvent>& contacts) {
+    if (!m_currentLevel || !m_currentLevel->getObjective()) return;
+
+    m_currentLevel->getObjective()->onContacts(contacts);
+}
+
 } // namespace GravityPaint
@@ -21,8 +21,7 @@ ReachGoalObjective::ReachGoalObjective(int requiredCount)
 void ReachGoalObjective::update(float /*deltaTime*/, PhysicsWorld* physics) {
     if (!physics) return;
 
-    auto objectsInGoal = physics->getObjectsInGoal();
-    m_currentCount = static_cast<int>(objectsInGoal.size());
+    m_currentCount = physics->getGoalCount();
 }
 
 bool ReachGoalObjective::isComplete() const {
@@ -53,7 +52,7 @@ void CollectItemsObjective::update(float /*deltaTime*/, PhysicsWorld* physics) {
     // Count collected objects
     int collected = 0;
     for (const auto& obj : physics->getObjects()) {
-        if (obj->isCollected()) {
+        if (obj.isCollected()) {
             collected++;
         }
     }
@@ -92,7 +91,7 @@ void TimeChallengeObjective::update(float deltaTime, PhysicsWorld* physics) {
     }
 
     if (physics) {
-        m_currentGoals = static_cast<int>(physics->getObjectsInGoal().size());
+        m_currentGoals = physics->getGoalCount();
     }
 }
 
@@ -146,6 +145,15 @@ std::string ChainReactionObjective::getDescription() const {
     return ss.str();
 }
 
+void ChainReactionObjective::onContacts(const std::vector<ContactEvent>& contacts) {
+    // Only new impacts extend the chain, not objects resting on each other
+    for (const auto& contact : contacts) {
+        if (contact.began) {
+            recordCollision();
+        }
+    }
+}
+
 void ChainReactionObjective::recordCollision() {
     m_currentChainLength++;
     m_chainTimeout = COMBO_TIMEOUT;
@@ -170,7 +178,7 @@ MinimizeStrokesObjective::MinimizeStrokesObjective(int maxStrokes, int requiredG
 
 void MinimizeStrokesObjective::update(float /*deltaTime*/, PhysicsWorld* physics) {
     if (physics) {
-        m_currentGoals = static_cast<int>(physics->getObjectsInGoal().size());
+        m_currentGoals = physics->getGoalCount();
     }
 
     if (m_strokesUsed > m_maxStrokes && m_currentGoals < m_requiredGoals) {
@@ -210,8 +218,10 @@ void MaximizeEnergyObjective::update(float /*deltaTime*/, PhysicsWorld* physics)
 
     // Sum energy of objects in goal
     m_totalEnergy = 0;
-    for (const auto& obj : physics->getObjectsInGoal()) {
-        m_totalEnergy += obj->getEnergy();
+    for (const auto& obj : physics->getObjects()) {
+        if (obj.hasReachedGoal()) {
+            m_totalEnergy += obj.getEnergy();
+        }
     }
 }
 
@@ -1,6 +1,9 @@
 #include "GravityPaint/physics/DeformableSurface.h"
+#include "GravityPaint/physics/SimdFloat4.h"
 #include "GravityPaint/Constants.h"
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 namespace GravityPaint {
 
@@ -13,184 +16,800 @@ DeformableSurface::DeformableSurface(const Vec2& position, float width, float he
 {
     createMesh();
     createSprings();
+    rebuildGrid();
 }
 
+namespace {
+
+constexpr float MIN_SPRING_LENGTH = 0.0001f;
+constexpr float NODE_DAMPING = 0.98f;    // Per explicit substep
+constexpr float MIN_STIFFNESS = 0.001f;  // Keeps XPBD compliance finite
+
+} // namespace
+
 void DeformableSurface::createMesh() {
-    m_nodes.clear();
-    
+    size_t count = static_cast<size_t>(m_resolutionX) * m_resolutionY;
+    m_posX.assign(count, 0.0f);
+    m_posY.assign(count, 0.0f);
+    m_velX.assign(count, 0.0f);
+    m_velY.assign(count, 0.0f);
+    m_restX.assign(count, 0.0f);
+    m_restY.assign(count, 0.0f);
+    m_invMass.assign(count, 1.0f);
+
     float cellWidth = m_width / (m_resolutionX - 1);
     float cellHeight = m_height / (m_resolutionY - 1);
 
     for (int y = 0; y < m_resolutionY; ++y) {
         for (int x = 0; x < m_resolutionX; ++x) {
-            SurfaceNode node;
-            node.position = Vec2(
-                m_position.x - m_width / 2 + x * cellWidth,
-                m_position.y - m_height / 2 + y * cellHeight
-            );
-            node.restPosition = node.position;
-            node.velocity = Vec2(0, 0);
-            node.mass = 1.0f;
-            
+            size_t index = static_cast<size_t>(y) * m_resolutionX + x;
+            m_restX[index] = m_position.x - m_width / 2 + x * cellWidth;
+            m_restY[index] = m_position.y - m_height / 2 + y * cellHeight;
+
             // Fix edge nodes
-            node.isFixed = (y == 0 || y == m_resolutionY - 1 || x == 0 || x == m_resolutionX - 1);
-            
-            m_nodes.push_back(node);
+            if (y == 0 || y == m_resolutionY - 1 || x == 0 || x == m_resolutionX - 1) {
+                m_invMass[index] = 0.0f;
+            }
         }
     }
+
+    m_posX = m_restX;
+    m_posY = m_restY;
 }
 
 void DeformableSurface::createSprings() {
-    m_springs.clear();
+    m_springA.clear();
+    m_springB.clear();
+    m_springRest.clear();
+    m_springStiffness.clear();
+    m_springDamping.clear();
 
     float cellWidth = m_width / (m_resolutionX - 1);
     float cellHeight = m_height / (m_resolutionY - 1);
+    float diagLength = std::sqrt(cellWidth * cellWidth + cellHeight * cellHeight);
 
-    for (int y = 0; y < m_resolutionY; ++y) {
-        for (int x = 0; x < m_resolutionX; ++x) {
+    // Column by column, vertical springs first and then those crossing to
+    // the next column, so within each color the springs of a column range
+    // are contiguous (see activeSprings)
+    for (int x = 0; x < m_resolutionX; ++x) {
+        for (int y = 0; y + 1 < m_resolutionY; ++y) {
+            int index = y * m_resolutionX + x;
+            addSpring(index, index + m_resolutionX, cellHeight, m_defaultStiffness, m_defaultDamping);
+        }
+
+        if (x + 1 == m_resolutionX) break;
+
+        for (int y = 0; y < m_resolutionY; ++y) {
             int index = y * m_resolutionX + x;
 
             // Horizontal spring
-            if (x < m_resolutionX - 1) {
-                SurfaceSpring spring;
-                spring.nodeA = index;
-                spring.nodeB = index + 1;
-                spring.restLength = cellWidth;
-                spring.stiffness = m_defaultStiffness;
-                spring.damping = m_defaultDamping;
-                m_springs.push_back(spring);
-            }
+            addSpring(index, index + 1, cellWidth, m_defaultStiffness, m_defaultDamping);
 
-            // Vertical spring
+            // Diagonal springs for stability
             if (y < m_resolutionY - 1) {
-                SurfaceSpring spring;
-                spring.nodeA = index;
-                spring.nodeB = index + m_resolutionX;
-                spring.restLength = cellHeight;
-                spring.stiffness = m_defaultStiffness;
-                spring.damping = m_defaultDamping;
-                m_springs.push_back(spring);
+                addSpring(index, index + m_resolutionX + 1, diagLength,
+                          m_defaultStiffness * 0.5f, m_defaultDamping * 0.5f);
+                addSpring(index + 1, index + m_resolutionX, diagLength,
+                          m_defaultStiffness * 0.5f, m_defaultDamping * 0.5f);
             }
+        }
+    }
 
-            // Diagonal springs for stability
-            if (x < m_resolutionX - 1 && y < m_resolutionY - 1) {
-                float diagLength = std::sqrt(cellWidth * cellWidth + cellHeight * cellHeight);
-                
-                SurfaceSpring spring1;
-                spring1.nodeA = index;
-                spring1.nodeB = index + m_resolutionX + 1;
-                spring1.restLength = diagLength;
-                spring1.stiffness = m_defaultStiffness * 0.5f;
-                spring1.damping = m_defaultDamping * 0.5f;
-                m_springs.push_back(spring1);
-
-                SurfaceSpring spring2;
-                spring2.nodeA = index + 1;
-                spring2.nodeB = index + m_resolutionX;
-                spring2.restLength = diagLength;
-                spring2.stiffness = m_defaultStiffness * 0.5f;
-                spring2.damping = m_defaultDamping * 0.5f;
-                m_springs.push_back(spring2);
-            }
+    colorSprings();
+
+    // The explicit solver's stencil holds the same springs
+    m_stencilRest = {cellWidth, cellHeight, diagLength, diagLength};
+    m_stencilStiffness = {m_defaultStiffness, m_defaultStiffness,
+                          m_defaultStiffness * 0.5f, m_defaultStiffness * 0.5f};
+    m_stencilDamping = {m_defaultDamping, m_defaultDamping,
+                        m_defaultDamping * 0.5f, m_defaultDamping * 0.5f};
+
+    m_stencilPad = static_cast<size_t>(m_resolutionX) + 1;
+    for (int direction = 0; direction < STENCIL_DIRECTIONS; ++direction) {
+        m_impulseX[direction].assign(m_stencilPad + m_posX.size(), 0.0f);
+        m_impulseY[direction].assign(m_stencilPad + m_posX.size(), 0.0f);
+    }
+}
+
+void DeformableSurface::addSpring(int nodeA, int nodeB, float restLength, float stiffness, float damping) {
+    m_springA.push_back(nodeA);
+    m_springB.push_back(nodeB);
+    m_springRest.push_back(restLength);
+    m_springStiffness.push_back(stiffness);
+    m_springDamping.push_back(damping);
+}
+
+void DeformableSurface::colorSprings() {
+    size_t springCount = m_springA.size();
+
+    // Greedy coloring: each spring takes the lowest color neither of its
+    // nodes has used yet. Grid nodes have at most eight springs, so this
+    // needs at most 15 colors and fits the 64-bit masks with room to spare.
+    std::vector<uint64_t> used(m_posX.size(), 0);
+    std::vector<uint32_t> colors(springCount);
+    uint32_t colorCount = 0;
+
+    for (size_t i = 0; i < springCount; ++i) {
+        uint64_t taken = used[m_springA[i]] | used[m_springB[i]];
+        uint32_t color = 0;
+        while (taken & (uint64_t(1) << color)) {
+            ++color;
         }
+
+        colors[i] = color;
+        used[m_springA[i]] |= uint64_t(1) << color;
+        used[m_springB[i]] |= uint64_t(1) << color;
+        colorCount = std::max(colorCount, color + 1);
+    }
+
+    // Counting sort by color, keeping creation order within a color
+    m_colorStart.assign(colorCount + 1, 0);
+    for (uint32_t color : colors) {
+        m_colorStart[color + 1]++;
     }
+    for (uint32_t c = 0; c < colorCount; ++c) {
+        m_colorStart[c + 1] += m_colorStart[c];
+    }
+
+    std::vector<uint32_t> order(springCount);
+    std::vector<uint32_t> next(m_colorStart.begin(), m_colorStart.end() - 1);
+    for (size_t i = 0; i < springCount; ++i) {
+        order[next[colors[i]]++] = static_cast<uint32_t>(i);
+    }
+
+    auto permute = [&order](auto& values) {
+        auto sorted = values;
+        for (size_t i = 0; i < order.size(); ++i) {
+            sorted[i] = values[order[i]];
+        }
+        values.swap(sorted);
+    };
+    permute(m_springA);
+    permute(m_springB);
+    permute(m_springRest);
+    permute(m_springStiffness);
+    permute(m_springDamping);
 }
 
 void DeformableSurface::update(float deltaTime) {
-    // Multiple physics substeps for stability
-    int substeps = 4;
-    float subDt = deltaTime / substeps;
+    if (!m_awake) return;
+
+    if (m_solver == SurfaceSolver::XPBD) {
+        updateXPBD(deltaTime);
+    } else {
+        // Multiple physics substeps for stability
+        float subDt = deltaTime / SURFACE_SPRING_SUBSTEPS;
+        for (int s = 0; s < SURFACE_SPRING_SUBSTEPS; ++s) {
+            updatePhysics(subDt);
+        }
+    }
 
-    for (int s = 0; s < substeps; ++s) {
-        updatePhysics(subDt);
-        applyConstraints();
+    updateRestState(deltaTime);
+    if (m_awake) {
+        rebuildGrid();
     }
 }
 
+void DeformableSurface::setIterations(int iterations) {
+    m_iterations = std::max(1, iterations);
+}
+
 void DeformableSurface::updatePhysics(float deltaTime) {
-    // Apply spring forces
-    for (const auto& spring : m_springs) {
-        SurfaceNode& nodeA = m_nodes[spring.nodeA];
-        SurfaceNode& nodeB = m_nodes[spring.nodeB];
+    // Every spring sees the same node state (Jacobi), so the directions
+    // are independent and need no coloring
+    for (int direction = 0; direction < STENCIL_DIRECTIONS; ++direction) {
+        solveSprings(direction, deltaTime);
+    }
 
-        Vec2 delta = nodeB.position - nodeA.position;
-        float currentLength = delta.length();
-        
-        if (currentLength < 0.0001f) continue;
+    for (int y = 0; y < m_resolutionY; ++y) {
+        size_t row = static_cast<size_t>(y) * m_resolutionX;
+        integrateSprings(row + m_columnBegin, row + m_columnEnd, deltaTime);
+    }
+}
+
+void DeformableSurface::updateXPBD(float deltaTime) {
+    if (deltaTime <= 0.0f) return;
+
+    m_prevX = m_posX;
+    m_prevY = m_posY;
+
+    // Predict with the rest pull only; damping matches what the explicit
+    // solver applies over its substeps so both look alike at equal settings
+    integrateRegion(deltaTime, std::pow(NODE_DAMPING, static_cast<float>(SURFACE_SPRING_SUBSTEPS)));
+
+    m_springLambda.assign(m_springA.size(), 0.0f);
+    for (int iteration = 0; iteration < m_iterations; ++iteration) {
+        for (size_t c = 0; c + 1 < m_colorStart.size(); ++c) {
+            size_t begin, end;
+            activeSprings(c, begin, end);
+            solveConstraints(begin, end, deltaTime);
+        }
+    }
+
+    // Velocities follow from the corrected positions
+    float invDt = 1.0f / deltaTime;
+    for (int y = 0; y < m_resolutionY; ++y) {
+        size_t row = static_cast<size_t>(y) * m_resolutionX;
+        for (size_t i = row + m_columnBegin; i < row + m_columnEnd; ++i) {
+            m_velX[i] = (m_posX[i] - m_prevX[i]) * invDt;
+            m_velY[i] = (m_posY[i] - m_prevY[i]) * invDt;
+        }
+    }
+}
+
+void DeformableSurface::integrateRegion(float deltaTime, float damping) {
+    for (int y = 0; y < m_resolutionY; ++y) {
+        size_t row = static_cast<size_t>(y) * m_resolutionX;
+        integrateNodes(row + m_columnBegin, row + m_columnEnd, deltaTime, damping);
+    }
+}
+
+void DeformableSurface::integrateNodes(size_t begin, size_t end, float deltaTime, float damping) {
+    // Return-to-rest force, damping and integration. Fixed nodes sit at
+    // rest with zero velocity and no spring ever moves them, so they can
+    // run through the same lanes and stay put.
+    const Float4 pull = Float4::splat(m_elasticity * deltaTime);
+    const Float4 dampingLanes = Float4::splat(damping);
+    const Float4 dt = Float4::splat(deltaTime);
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        Float4 posX = Float4::load(&m_posX[i]);
+        Float4 posY = Float4::load(&m_posY[i]);
+        Float4 velX = (Float4::load(&m_velX[i]) + (Float4::load(&m_restX[i]) - posX) * pull) * dampingLanes;
+        Float4 velY = (Float4::load(&m_velY[i]) + (Float4::load(&m_restY[i]) - posY) * pull) * dampingLanes;
+
+        velX.store(&m_velX[i]);
+        velY.store(&m_velY[i]);
+        (posX + velX * dt).store(&m_posX[i]);
+        (posY + velY * dt).store(&m_posY[i]);
+    }
+
+    float pullScalar = m_elasticity * deltaTime;
+    for (; i < end; ++i) {
+        m_velX[i] = (m_velX[i] + (m_restX[i] - m_posX[i]) * pullScalar) * damping;
+        m_velY[i] = (m_velY[i] + (m_restY[i] - m_posY[i]) * pullScalar) * damping;
+        m_posX[i] += m_velX[i] * deltaTime;
+        m_posY[i] += m_velY[i] * deltaTime;
+    }
+}
+
+void DeformableSurface::solveSprings(int direction, float deltaTime) {
+    // Node offsets from the anchor, and whether the spring reaches into the
+    // next column (then the anchor's column must not be the last awake one)
+    const size_t stride = static_cast<size_t>(m_resolutionX);
+    size_t offsetA = direction == DiagonalUp ? 1 : 0;
+    size_t offsetB = direction == Horizontal ? 1 : direction == DiagonalDown ? stride + 1 : stride;
+    int crossing = direction == Vertical ? 0 : 1;
+    int rows = direction == Horizontal ? m_resolutionY : m_resolutionY - 1;
+
+    float rest = m_stencilRest[direction];
+    float stiffnessDt = m_stencilStiffness[direction] * deltaTime;
+    float dampingDt = m_stencilDamping[direction] * deltaTime;
+    float* impulseX = m_impulseX[direction].data() + m_stencilPad;  // Indexed by anchor node
+    float* impulseY = m_impulseY[direction].data() + m_stencilPad;
+
+    const Float4 minLengthSq = Float4::splat(MIN_SPRING_LENGTH * MIN_SPRING_LENGTH);
+    const Float4 one = Float4::splat(1.0f);
+    const Float4 restLanes = Float4::splat(rest);
+    const Float4 stiffnessLanes = Float4::splat(stiffnessDt);
+    const Float4 dampingLanes = Float4::splat(dampingDt);
+
+    for (int y = 0; y < rows; ++y) {
+        size_t row = static_cast<size_t>(y) * stride;
+        size_t i = row + m_columnBegin;
+        size_t end = row + m_columnEnd - crossing;
+
+        // Four neighbouring anchors are four adjacent springs, so both
+        // ends load contiguously
+        for (; i + 4 <= end; i += 4) {
+            size_t a = i + offsetA;
+            size_t b = i + offsetB;
+            Float4 dx = Float4::load(&m_posX[b]) - Float4::load(&m_posX[a]);
+            Float4 dy = Float4::load(&m_posY[b]) - Float4::load(&m_posY[a]);
+            Float4 lengthSq = dx * dx + dy * dy;
+            Float4 length = Float4::sqrt(lengthSq);
+
+            // Degenerate springs get a zero direction and so no impulse
+            Float4 invLength = Float4::select(Float4::greaterEqual(lengthSq, minLengthSq), one / length);
+            Float4 dirX = dx * invLength;
+            Float4 dirY = dy * invLength;
+
+            // Hooke's law plus damping along the spring
+            Float4 relativeVelocity = (Float4::load(&m_velX[b]) - Float4::load(&m_velX[a])) * dirX +
+                                      (Float4::load(&m_velY[b]) - Float4::load(&m_velY[a])) * dirY;
+            Float4 magnitude = (length - restLanes) * stiffnessLanes + relativeVelocity * dampingLanes;
+            (dirX * magnitude).store(&impulseX[i]);
+            (dirY * magnitude).store(&impulseY[i]);
+        }
+
+        for (; i < end; ++i) {
+            size_t a = i + offsetA;
+            size_t b = i + offsetB;
+            float dx = m_posX[b] - m_posX[a];
+            float dy = m_posY[b] - m_posY[a];
+            float length = std::sqrt(dx * dx + dy * dy);
+            if (length < MIN_SPRING_LENGTH) {
+                impulseX[i] = 0.0f;
+                impulseY[i] = 0.0f;
+                continue;
+            }
 
-        Vec2 direction = delta / currentLength;
-        float displacement = currentLength - spring.restLength;
+            float dirX = dx / length;
+            float dirY = dy / length;
+            float relativeVelocity = (m_velX[b] - m_velX[a]) * dirX + (m_velY[b] - m_velY[a]) * dirY;
+            float magnitude = (length - rest) * stiffnessDt + relativeVelocity * dampingDt;
+            impulseX[i] = dirX * magnitude;
+            impulseY[i] = dirY * magnitude;
+        }
+    }
+}
 
-        // Spring force (Hooke's law)
-        Vec2 springForce = direction * displacement * spring.stiffness;
+void DeformableSurface::integrateSprings(size_t begin, size_t end, float deltaTime) {
+    // Each node gains the impulse of the springs it starts and loses that
+    // of the springs it ends, read at its own index and at the anchors up
+    // and to the left; then it is pulled to rest, damped and integrated as
+    // in integrateNodes. Impulse index k is node k - m_stencilPad, so the
+    // first row's up-left reads land in the zero padding. Fixed nodes take
+    // no impulse at all: an overflowing one times their zero inverse mass
+    // would be NaN.
+    const size_t stride = static_cast<size_t>(m_resolutionX);
+    const float* horizontalX = m_impulseX[Horizontal].data();
+    const float* horizontalY = m_impulseY[Horizontal].data();
+    const float* verticalX = m_impulseX[Vertical].data();
+    const float* verticalY = m_impulseY[Vertical].data();
+    const float* downX = m_impulseX[DiagonalDown].data();
+    const float* downY = m_impulseY[DiagonalDown].data();
+    const float* upX = m_impulseX[DiagonalUp].data();
+    const float* upY = m_impulseY[DiagonalUp].data();
+
+    auto gather = [stride](const float* h, const float* v, const float* down, const float* up, size_t k) {
+        return (h[k] - h[k - 1]) + (v[k] - v[k - stride]) +
+               (down[k] - down[k - stride - 1]) + (up[k - 1] - up[k - stride]);
+    };
+    auto gather4 = [stride](const float* h, const float* v, const float* down, const float* up, size_t k) {
+        return (Float4::load(&h[k]) - Float4::load(&h[k - 1])) +
+               (Float4::load(&v[k]) - Float4::load(&v[k - stride])) +
+               (Float4::load(&down[k]) - Float4::load(&down[k - stride - 1])) +
+               (Float4::load(&up[k - 1]) - Float4::load(&up[k - stride]));
+    };
+
+    const Float4 pull = Float4::splat(m_elasticity * deltaTime);
+    const Float4 damping = Float4::splat(NODE_DAMPING);
+    const Float4 dt = Float4::splat(deltaTime);
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        size_t k = i + m_stencilPad;
+        Float4 invMass = Float4::load(&m_invMass[i]);
+        Float4 fixed = Float4::lessEqual(invMass, Float4::zero());
+        Float4 posX = Float4::load(&m_posX[i]);
+        Float4 posY = Float4::load(&m_posY[i]);
+        Float4 impulseX = gather4(horizontalX, verticalX, downX, upX, k) * invMass;
+        Float4 impulseY = gather4(horizontalY, verticalY, downY, upY, k) * invMass;
+        Float4 velX = Float4::load(&m_velX[i]) + Float4::blend(fixed, Float4::zero(), impulseX);
+        Float4 velY = Float4::load(&m_velY[i]) + Float4::blend(fixed, Float4::zero(), impulseY);
+        velX = (velX + (Float4::load(&m_restX[i]) - posX) * pull) * damping;
+        velY = (velY + (Float4::load(&m_restY[i]) - posY) * pull) * damping;
+
+        velX.store(&m_velX[i]);
+        velY.store(&m_velY[i]);
+        (posX + velX * dt).store(&m_posX[i]);
+        (posY + velY * dt).store(&m_posY[i]);
+    }
 
-        // Damping force
-        Vec2 relativeVelocity = nodeB.velocity - nodeA.velocity;
-        Vec2 dampingForce = direction * relativeVelocity.dot(direction) * spring.damping;
+    float pullScalar = m_elasticity * deltaTime;
+    for (; i < end; ++i) {
+        size_t k = i + m_stencilPad;
+        float velX = m_velX[i];
+        float velY = m_velY[i];
+        if (m_invMass[i] > 0.0f) {
+            velX += gather(horizontalX, verticalX, downX, upX, k) * m_invMass[i];
+            velY += gather(horizontalY, verticalY, downY, upY, k) * m_invMass[i];
+        }
+        m_velX[i] = (velX + (m_restX[i] - m_posX[i]) * pullScalar) * NODE_DAMPING;
+        m_velY[i] = (velY + (m_restY[i] - m_posY[i]) * pullScalar) * NODE_DAMPING;
+        m_posX[i] += m_velX[i] * deltaTime;
+        m_posY[i] += m_velY[i] * deltaTime;
+    }
+}
 
-        Vec2 totalForce = springForce + dampingForce;
+void DeformableSurface::solveConstraints(size_t begin, size_t end, float deltaTime) {
+    // XPBD distance constraint per spring, C = length - rest, with
+    // compliance 1 / (stiffness * dt^2) and spring damping folded in as
+    // gamma = damping / (stiffness * dt) against motion since the step began
+    const Float4 minLengthSq = Float4::splat(MIN_SPRING_LENGTH * MIN_SPRING_LENGTH);
+    const Float4 minStiffness = Float4::splat(MIN_STIFFNESS);
+    const Float4 one = Float4::splat(1.0f);
+    const Float4 dt = Float4::splat(deltaTime);
+    const Float4 dtSq = Float4::splat(deltaTime * deltaTime);
+
+    float ax[4], ay[4], bx[4], by[4];
+    float apx[4], apy[4], bpx[4], bpy[4];
+    float aw[4], bw[4];
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        for (int lane = 0; lane < 4; ++lane) {
+            int32_t a = m_springA[i + lane];
+            int32_t b = m_springB[i + lane];
+            ax[lane] = m_posX[a];
+            ay[lane] = m_posY[a];
+            bx[lane] = m_posX[b];
+            by[lane] = m_posY[b];
+            apx[lane] = m_prevX[a];
+            apy[lane] = m_prevY[a];
+            bpx[lane] = m_prevX[b];
+            bpy[lane] = m_prevY[b];
+            aw[lane] = m_invMass[a];
+            bw[lane] = m_invMass[b];
+        }
 
-        if (!nodeA.isFixed) {
-            nodeA.velocity += totalForce * (deltaTime / nodeA.mass);
+        Float4 posAX = Float4::load(ax);
+        Float4 posAY = Float4::load(ay);
+        Float4 posBX = Float4::load(bx);
+        Float4 posBY = Float4::load(by);
+
+        Float4 dx = posBX - posAX;
+        Float4 dy = posBY - posAY;
+        Float4 lengthSq = dx * dx + dy * dy;
+        Float4 length = Float4::sqrt(lengthSq);
+        Float4 valid = Float4::greaterEqual(lengthSq, minLengthSq);
+        Float4 invLength = Float4::select(valid, one / length);
+        Float4 normalX = dx * invLength;
+        Float4 normalY = dy * invLength;
+
+        Float4 alpha = one / (Float4::max(Float4::load(&m_springStiffness[i]), minStiffness) * dtSq);
+        Float4 gamma = Float4::load(&m_springDamping[i]) * alpha * dt;
+        Float4 motion = ((posBX - Float4::load(bpx)) - (posAX - Float4::load(apx))) * normalX +
+                        ((posBY - Float4::load(bpy)) - (posAY - Float4::load(apy))) * normalY;
+
+        Float4 weightA = Float4::load(aw);
+        Float4 weightB = Float4::load(bw);
+        Float4 lambda = Float4::load(&m_springLambda[i]);
+        Float4 constraint = length - Float4::load(&m_springRest[i]);
+        Float4 deltaLambda = Float4::select(valid,
+            (Float4::zero() - constraint - alpha * lambda - gamma * motion) /
+            ((one + gamma) * (weightA + weightB) + alpha));
+        (lambda + deltaLambda).store(&m_springLambda[i]);
+
+        Float4 correctionX = normalX * deltaLambda;
+        Float4 correctionY = normalY * deltaLambda;
+        (posAX - correctionX * weightA).store(ax);
+        (posAY - correctionY * weightA).store(ay);
+        (posBX + correctionX * weightB).store(bx);
+        (posBY + correctionY * weightB).store(by);
+
+        for (int lane = 0; lane < 4; ++lane) {
+            int32_t a = m_springA[i + lane];
+            int32_t b = m_springB[i + lane];
+            m_posX[a] = ax[lane];
+            m_posY[a] = ay[lane];
+            m_posX[b] = bx[lane];
+            m_posY[b] = by[lane];
         }
-        if (!nodeB.isFixed) {
-            nodeB.velocity -= totalForce * (deltaTime / nodeB.mass);
+    }
+
+    // Scalar tail of the color
+    for (; i < end; ++i) {
+        int32_t a = m_springA[i];
+        int32_t b = m_springB[i];
+
+        float dx = m_posX[b] - m_posX[a];
+        float dy = m_posY[b] - m_posY[a];
+        float length = std::sqrt(dx * dx + dy * dy);
+        if (length < MIN_SPRING_LENGTH) continue;
+
+        float normalX = dx / length;
+        float normalY = dy / length;
+        float alpha = 1.0f / (std::max(m_springStiffness[i], MIN_STIFFNESS) * deltaTime * deltaTime);
+        float gamma = m_springDamping[i] * alpha * deltaTime;
+        float motion = ((m_posX[b] - m_prevX[b]) - (m_posX[a] - m_prevX[a])) * normalX +
+                       ((m_posY[b] - m_prevY[b]) - (m_posY[a] - m_prevY[a])) * normalY;
+
+        float deltaLambda = (-(length - m_springRest[i]) - alpha * m_springLambda[i] - gamma * motion) /
+                            ((1.0f + gamma) * (m_invMass[a] + m_invMass[b]) + alpha);
+        m_springLambda[i] += deltaLambda;
+
+        m_posX[a] -= normalX * deltaLambda * m_invMass[a];
+        m_posY[a] -= normalY * deltaLambda * m_invMass[a];
+        m_posX[b] += normalX * deltaLambda * m_invMass[b];
+        m_posY[b] += normalY * deltaLambda * m_invMass[b];
+    }
+}
+
+void DeformableSurface::activeSprings(size_t color, size_t& begin, size_t& end) const {
+    // Springs were created column by column, vertical ones before those
+    // crossing to the next column. Keyed that way, the keys never decrease
+    // within a color, and the springs lying wholly inside the awake columns
+    // form one contiguous run.
+    auto key = [this](size_t spring) {
+        int columnA = m_springA[spring] % m_resolutionX;
+        int columnB = m_springB[spring] % m_resolutionX;
+        return 2 * std::min(columnA, columnB) + (columnA != columnB ? 1 : 0);
+    };
+    auto firstAt = [&](int target) {
+        size_t lo = m_colorStart[color];
+        size_t hi = m_colorStart[color + 1];
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (key(mid) < target) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
         }
+        return lo;
+    };
+
+    // The last awake column keeps its vertical springs; only the ones
+    // crossing out of it reach past the region
+    begin = firstAt(2 * m_columnBegin);
+    end = firstAt(2 * m_columnEnd - 1);
+}
+
+size_t DeformableSurface::getActiveSpringCount() const {
+    if (!m_awake) return 0;
+
+    size_t count = 0;
+    for (size_t c = 0; c + 1 < m_colorStart.size(); ++c) {
+        size_t begin, end;
+        activeSprings(c, begin, end);
+        count += end - begin;
+    }
+    return count;
+}
+
+void DeformableSurface::wakeColumns(int first, int last) {
+    first = std::max(0, first);
+    last = std::min(m_resolutionX - 1, last);
+    if (first > last) return;
+
+    if (m_awake) {
+        m_columnBegin = std::min(m_columnBegin, first);
+        m_columnEnd = std::max(m_columnEnd, last + 1);
+    } else {
+        m_awake = true;
+        m_columnBegin = first;
+        m_columnEnd = last + 1;
     }
+    m_restTime = 0.0f;
+}
+
+void DeformableSurface::updateRestState(float deltaTime) {
+    // Kinetic energy and offset from rest per node. Motion in an edge column
+    // means the disturbance is spreading, so the region grows; once nothing
+    // moves for long enough the surface sleeps.
+    const float restDistanceSq = SURFACE_SLEEP_DISTANCE * SURFACE_SLEEP_DISTANCE;
+    bool settled = true;
+    bool busyFirst = false;
+    bool busyLast = false;
 
-    // Apply return-to-rest force
-    for (auto& node : m_nodes) {
-        if (!node.isFixed) {
-            Vec2 toRest = node.restPosition - node.position;
-            node.velocity += toRest * (m_elasticity * deltaTime);
-            node.velocity *= 0.98f; // Damping
+    for (int y = 0; y < m_resolutionY; ++y) {
+        size_t row = static_cast<size_t>(y) * m_resolutionX;
+        for (int x = m_columnBegin; x < m_columnEnd; ++x) {
+            size_t i = row + x;
+            if (m_invMass[i] == 0.0f) continue;
+
+            // Kinetic energy 0.5 * v^2 / invMass, compared without the divide
+            float speedSq = m_velX[i] * m_velX[i] + m_velY[i] * m_velY[i];
+            float dx = m_posX[i] - m_restX[i];
+            float dy = m_posY[i] - m_restY[i];
+            if (0.5f * speedSq <= SURFACE_SLEEP_ENERGY * m_invMass[i] && dx * dx + dy * dy <= restDistanceSq) continue;
+
+            settled = false;
+            busyFirst |= x == m_columnBegin;
+            busyLast |= x == m_columnEnd - 1;
         }
     }
 
-    // Integrate velocities
-    for (auto& node : m_nodes) {
-        if (!node.isFixed) {
-            node.position += node.velocity * deltaTime;
+    if (!settled) {
+        m_restTime = 0.0f;
+        if (busyFirst) {
+            wakeColumns(m_columnBegin - SURFACE_WAKE_MARGIN, m_columnBegin);
+        }
+        if (busyLast) {
+            wakeColumns(m_columnEnd - 1, m_columnEnd - 1 + SURFACE_WAKE_MARGIN);
         }
+        return;
+    }
+
+    m_restTime += deltaTime;
+    if (m_restTime >= SURFACE_SLEEP_TIME) {
+        sleep();
+    }
+}
+
+void DeformableSurface::sleep() {
+    // Settled nodes are within a fraction of a pixel; snapping them keeps
+    // the outside-the-region-is-at-rest invariant exact
+    m_posX = m_restX;
+    m_posY = m_restY;
+    std::fill(m_velX.begin(), m_velX.end(), 0.0f);
+    std::fill(m_velY.begin(), m_velY.end(), 0.0f);
+    for (int direction = 0; direction < STENCIL_DIRECTIONS; ++direction) {
+        std::fill(m_impulseX[direction].begin(), m_impulseX[direction].end(), 0.0f);
+        std::fill(m_impulseY[direction].begin(), m_impulseY[direction].end(), 0.0f);
+    }
+
+    m_awake = false;
+    m_columnBegin = 0;
+    m_columnEnd = 0;
+    m_restTime = 0.0f;
+    rebuildGrid();
+}
+
+void DeformableSurface::rebuildGrid() {
+    size_t count = m_posX.size();
+    if (count == 0) return;
+
+    // Bounds in one pass, four nodes at a time. The running bound is the
+    // second operand so a NaN node keeps it, as std::min does below.
+    Float4 minX = Float4::splat(m_posX[0]);
+    Float4 maxX = minX;
+    Float4 minY = Float4::splat(m_posY[0]);
+    Float4 maxY = minY;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        Float4 x = Float4::load(&m_posX[i]);
+        Float4 y = Float4::load(&m_posY[i]);
+        minX = Float4::min(x, minX);
+        maxX = Float4::max(x, maxX);
+        minY = Float4::min(y, minY);
+        maxY = Float4::max(y, maxY);
+    }
+    float lanes[4][4];
+    minX.store(lanes[0]);
+    maxX.store(lanes[1]);
+    minY.store(lanes[2]);
+    maxY.store(lanes[3]);
+    m_boundsMinX = std::min({lanes[0][0], lanes[0][1], lanes[0][2], lanes[0][3]});
+    m_boundsMaxX = std::max({lanes[1][0], lanes[1][1], lanes[1][2], lanes[1][3]});
+    m_boundsMinY = std::min({lanes[2][0], lanes[2][1], lanes[2][2], lanes[2][3]});
+    m_boundsMaxY = std::max({lanes[3][0], lanes[3][1], lanes[3][2], lanes[3][3]});
+    for (; i < count; ++i) {
+        m_boundsMinX = std::min(m_boundsMinX, m_posX[i]);
+        m_boundsMaxX = std::max(m_boundsMaxX, m_posX[i]);
+        m_boundsMinY = std::min(m_boundsMinY, m_posY[i]);
+        m_boundsMaxY = std::max(m_boundsMaxY, m_posY[i]);
     }
+
+    // Cells about one mesh spacing across, so each holds a node or two.
+    // A badly stretched surface gets coarser cells rather than a huge grid.
+    float spacing = std::max(m_width / (m_resolutionX - 1), m_height / (m_resolutionY - 1));
+    float extentX = m_boundsMaxX - m_boundsMinX;
+    float extentY = m_boundsMaxY - m_boundsMinY;
+    if (std::isfinite(extentX) && std::isfinite(extentY)) {
+        m_gridCellSize = std::max({spacing, extentX / (2 * m_resolutionX), extentY / (2 * m_resolutionY), 1.0f});
+        m_gridColumns = static_cast<int>(extentX / m_gridCellSize) + 1;
+        m_gridRows = static_cast<int>(extentY / m_gridCellSize) + 1;
+    } else {
+        // A blown-up surface (too stiff for the explicit solver) still
+        // gets a valid, if useless, single-cell grid
+        m_gridCellSize = 1.0f;
+        m_gridColumns = 1;
+        m_gridRows = 1;
+    }
+
+    m_gridInvCellSize = 1.0f / m_gridCellSize;
+
+    // Counting sort of node indices by cell: count, turn counts into cell
+    // ends, then fill backwards so each end slides down to its cell's start
+    m_gridStart.assign(static_cast<size_t>(m_gridColumns) * m_gridRows + 1, 0);
+    m_gridCellOf.resize(count);
+    for (size_t node = 0; node < count; ++node) {
+        uint32_t cell = static_cast<uint32_t>(gridRow(m_posY[node]) * m_gridColumns + gridColumn(m_posX[node]));
+        m_gridCellOf[node] = cell;
+        m_gridStart[cell]++;
+    }
+    for (size_t c = 1; c < m_gridStart.size(); ++c) {
+        m_gridStart[c] += m_gridStart[c - 1];
+    }
+
+    m_gridNodes.resize(count);
+    for (size_t node = count; node-- > 0;) {
+        m_gridNodes[--m_gridStart[m_gridCellOf[node]]] = static_cast<uint32_t>(node);
+    }
+}
+
+int DeformableSurface::gridColumn(float x) const {
+    // Clamped before the cast so far-off points and NaN can't overflow it.
+    // Past the clamp the offset is non-negative, where truncation is floor.
+    float column = (x - m_boundsMinX) * m_gridInvCellSize;
+    return column >= 0.0f ? static_cast<int>(std::min(column, static_cast<float>(m_gridColumns - 1))) : 0;
+}
+
+int DeformableSurface::gridRow(float y) const {
+    float row = (y - m_boundsMinY) * m_gridInvCellSize;
+    return row >= 0.0f ? static_cast<int>(std::min(row, static_cast<float>(m_gridRows - 1))) : 0;
 }
 
-void DeformableSurface::applyConstraints() {
-    // Keep fixed nodes in place
-    for (auto& node : m_nodes) {
-        if (node.isFixed) {
-            node.position = node.restPosition;
-            node.velocity = Vec2(0, 0);
+int DeformableSurface::findNearestNode(const Vec2& point) const {
+    if (m_gridNodes.empty()) return -1;
+
+    int centerColumn = gridColumn(point.x);
+    int centerRow = gridRow(point.y);
+    int maxRing = std::max({centerColumn, m_gridColumns - 1 - centerColumn,
+                            centerRow, m_gridRows - 1 - centerRow});
+
+    int best = -1;
+    float bestDistSq = std::numeric_limits<float>::max();
+
+    // Widen a square of cells ring by ring until no unvisited cell can
+    // hold anything closer than the best node so far
+    for (int ring = 0; ring <= maxRing; ++ring) {
+        int firstRow = std::max(0, centerRow - ring);
+        int lastRow = std::min(m_gridRows - 1, centerRow + ring);
+        for (int row = firstRow; row <= lastRow; ++row) {
+            bool edgeRow = row == centerRow - ring || row == centerRow + ring;
+            int step = edgeRow ? 1 : 2 * ring;
+            for (int column = centerColumn - ring; column <= centerColumn + ring; column += std::max(1, step)) {
+                if (column < 0 || column >= m_gridColumns) continue;
+
+                size_t cell = static_cast<size_t>(row) * m_gridColumns + column;
+                for (uint32_t k = m_gridStart[cell]; k < m_gridStart[cell + 1]; ++k) {
+                    uint32_t i = m_gridNodes[k];
+                    float dx = m_posX[i] - point.x;
+                    float dy = m_posY[i] - point.y;
+                    float distSq = dx * dx + dy * dy;
+                    if (distSq < bestDistSq) {
+                        bestDistSq = distSq;
+                        best = static_cast<int>(i);
+                    }
+                }
+            }
         }
+
+        // Distance from the point to the outside of the visited square
+        float minX = m_boundsMinX + (centerColumn - ring) * m_gridCellSize;
+        float maxX = m_boundsMinX + (centerColumn + ring + 1) * m_gridCellSize;
+        float minY = m_boundsMinY + (centerRow - ring) * m_gridCellSize;
+        float maxY = m_boundsMinY + (centerRow + ring + 1) * m_gridCellSize;
+        float reach = std::min({point.x - minX, maxX - point.x, point.y - minY, maxY - point.y});
+        if (best >= 0 && reach > 0.0f && bestDistSq <= reach * reach) break;
     }
+
+    return best;
 }
 
 void DeformableSurface::applyImpact(const Vec2& point, float force) {
     float impactRadius = 50.0f;
     float impactRadiusSq = impactRadius * impactRadius;
 
-    for (auto& node : m_nodes) {
-        if (node.isFixed) continue;
+    // Only columns within the impact radius can be hit
+    float cellWidth = m_width / (m_resolutionX - 1);
+    float left = m_position.x - m_width / 2;
+    int first = static_cast<int>(std::floor((point.x - impactRadius - left) / cellWidth));
+    int last = static_cast<int>(std::ceil((point.x + impactRadius - left) / cellWidth));
+    first = std::max(0, first);
+    last = std::min(m_resolutionX - 1, last);
+    if (first > last) return;
+
+    wakeColumns(first - SURFACE_WAKE_MARGIN, last + SURFACE_WAKE_MARGIN);
+
+    for (int y = 0; y < m_resolutionY; ++y) {
+        for (int x = first; x <= last; ++x) {
+            size_t i = static_cast<size_t>(y) * m_resolutionX + x;
+            if (m_invMass[i] == 0.0f) continue;
 
-        Vec2 toNode = node.position - point;
-        float distSq = toNode.lengthSquared();
+            Vec2 toNode(m_posX[i] - point.x, m_posY[i] - point.y);
+            float distSq = toNode.lengthSquared();
 
-        if (distSq < impactRadiusSq && distSq > 0.0001f) {
-            float dist = std::sqrt(distSq);
-            float falloff = 1.0f - (dist / impactRadius);
-            falloff = falloff * falloff;
+            if (distSq < impactRadiusSq && distSq > 0.0001f) {
+                float dist = std::sqrt(distSq);
+                float falloff = 1.0f - (dist / impactRadius);
+                falloff = falloff * falloff;
 
-            Vec2 impulse = toNode.normalized() * force * falloff * 0.5f;
-            node.velocity += impulse;
+                Vec2 impulse = toNode.normalized() * force * falloff * 0.5f;
+                m_velX[i] += impulse.x;
+                m_velY[i] += impulse.y;
+            }
         }
     }
 }
 
 void DeformableSurface::reset() {
-    for (auto& node : m_nodes) {
-        node.position = node.restPosition;
-        node.velocity = Vec2(0, 0);
-    }
+    sleep();
 }
 
 void DeformableSurface::attachToWorld(b2World* world) {
@@ -209,65 +828,65 @@ void DeformableSurface::detachFromWorld() {
 }
 
 float DeformableSurface::getDeformationAt(const Vec2& point) const {
-    // Find nearest node and return its deformation
-    float minDist = std::numeric_limits<float>::max();
-    float deformation = 0.0f;
-
-    for (const auto& node : m_nodes) {
-        float dist = (node.position - point).length();
-        if (dist < minDist) {
-            minDist = dist;
-            deformation = (node.position - node.restPosition).length();
-        }
-    }
+    // Deformation of the nearest node
+    int node = findNearestNode(point);
+    if (node < 0) return 0.0f;
 
-    return deformation;
+    return (getNodePosition(node) - getNodeRestPosition(node)).length();
 }
 
 float DeformableSurface::getTotalDeformation() const {
     float total = 0.0f;
-    for (const auto& node : m_nodes) {
-        total += (node.position - node.restPosition).length();
+    for (size_t i = 0; i < m_posX.size(); ++i) {
+        total += (getNodePosition(i) - getNodeRestPosition(i)).length();
     }
     return total;
 }
 
 void DeformableSurface::setStiffness(float stiffness) {
     m_defaultStiffness = stiffness;
-    for (auto& spring : m_springs) {
-        spring.stiffness = stiffness;
-    }
+    std::fill(m_springStiffness.begin(), m_springStiffness.end(), stiffness);
+    m_stencilStiffness.fill(stiffness);
 }
 
 void DeformableSurface::setDamping(float damping) {
     m_defaultDamping = damping;
-    for (auto& spring : m_springs) {
-        spring.damping = damping;
-    }
+    std::fill(m_springDamping.begin(), m_springDamping.end(), damping);
+    m_stencilDamping.fill(damping);
 }
 
 bool DeformableSurface::isPointNear(const Vec2& point, float threshold) const {
-    for (const auto& node : m_nodes) {
-        if ((node.position - point).length() < threshold) {
-            return true;
+    if (m_gridNodes.empty() ||
+        point.x < m_boundsMinX - threshold || point.x > m_boundsMaxX + threshold ||
+        point.y < m_boundsMinY - threshold || point.y > m_boundsMaxY + threshold) {
+        return false;
+    }
+
+    float thresholdSq = threshold * threshold;
+    int firstColumn = gridColumn(point.x - threshold);
+    int lastColumn = gridColumn(point.x + threshold);
+    int firstRow = gridRow(point.y - threshold);
+    int lastRow = gridRow(point.y + threshold);
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            size_t cell = static_cast<size_t>(row) * m_gridColumns + column;
+            for (uint32_t k = m_gridStart[cell]; k < m_gridStart[cell + 1]; ++k) {
+                uint32_t i = m_gridNodes[k];
+                float dx = m_posX[i] - point.x;
+                float dy = m_posY[i] - point.y;
+                if (dx * dx + dy * dy < thresholdSq) {
+                    return true;
+                }
+            }
         }
     }
     return false;
 }
 
 Vec2 DeformableSurface::getNearestPoint(const Vec2& point) const {
-    float minDist = std::numeric_limits<float>::max();
-    Vec2 nearest = point;
-
-    for (const auto& node : m_nodes) {
-        float dist = (node.position - point).length();
-        if (dist < minDist) {
-            minDist = dist;
-            nearest = node.position;
-        }
-    }
-
-    return nearest;
+    int node = findNearestNode(point);
+    return node < 0 ? point : getNodePosition(node);
 }
 
 } // namespace GravityPaint
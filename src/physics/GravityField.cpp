@@ -1,4 +1,5 @@
 #include "GravityPaint/physics/GravityField.h"
+#include "GravityPaint/physics/WorldSnapshot.h"
 #include <cmath>
 
 namespace GravityPaint {
@@ -40,11 +41,48 @@ void GravityField::update(float deltaTime) {
     }
 }
 
+void GravityField::setPath(const std::vector<Vec2>& points) {
+    m_path.build(points);
+}
+
+void GravityField::captureState(FieldState& state) const {
+    state.position = m_position;
+    state.direction = m_direction;
+    state.strength = m_strength;
+    state.radius = m_radius;
+    state.lifetime = m_lifetime;
+    state.maxLifetime = m_maxLifetime;
+    state.pulsePhase = m_pulsePhase;
+    state.active = m_active;
+}
+
+void GravityField::restoreState(const FieldState& state) {
+    m_position = state.position;
+    m_direction = state.direction;
+    m_strength = state.strength;
+    m_radius = state.radius;
+    m_lifetime = state.lifetime;
+    m_maxLifetime = state.maxLifetime;
+    m_pulsePhase = state.pulsePhase;
+    m_active = state.active;
+}
+
 Vec2 GravityField::calculateForce(const Vec2& objectPosition) const {
     if (!m_active) return Vec2(0, 0);
 
-    Vec2 toObject = objectPosition - m_position;
-    float distance = toObject.length();
+    // Radial fields measure from their position, path fields from the nearest segment
+    Vec2 origin = m_position;
+    float distance = 0.0f;
+
+    if (hasPath()) {
+        if (!m_path.findClosest(objectPosition, m_radius, origin, distance)) {
+            return Vec2(0, 0);
+        }
+    } else {
+        distance = (objectPosition - m_position).length();
+    }
+
+    Vec2 toObject = objectPosition - origin;
 
     if (distance > m_radius || distance < 0.001f) {
         return Vec2(0, 0);
@@ -75,7 +113,7 @@ Vec2 GravityField::calculateForce(const Vec2& objectPosition) const {
 
         case ZoneType::Attract: {
             // Pull toward center
-            Vec2 toCenter = (m_position - objectPosition).normalized();
+            Vec2 toCenter = (origin - objectPosition).normalized();
             force = toCenter * m_strength * falloff;
             break;
         }
@@ -97,6 +135,11 @@ Vec2 GravityField::calculateForce(const Vec2& objectPosition) const {
 }
 
 bool GravityField::isPointInRange(const Vec2& point) const {
+    if (hasPath()) {
+        Vec2 closest;
+        float distance;
+        return m_path.findClosest(point, m_radius, closest, distance);
+    }
     return (point - m_position).lengthSquared() <= m_radius * m_radius;
 }
 
@@ -0,0 +1,242 @@
+#include "GravityPaint/physics/GravityKernel.h"
+#include "GravityPaint/physics/GravityField.h"
+#include "GravityPaint/physics/SimdFloat4.h"
+#include <cmath>
+
+namespace GravityPaint {
+
+namespace {
+
+// Per-field constants shared by the vector and scalar paths
+struct FieldParams {
+    float centerX;
+    float centerY;
+    float radius;
+    float strength;
+    float pushX;  // Direction * strength * zone scale, for directional zones
+    float pushY;
+};
+
+constexpr float MIN_DISTANCE = 0.001f;
+
+// Above this many segments a BVH walk per position beats testing every
+// segment four positions at a time (see GravityPathBench)
+constexpr size_t PATH_KERNEL_MAX_SEGMENTS = 40;
+
+constexpr bool isRadialZone(ZoneType zone) {
+    return zone == ZoneType::Attract || zone == ZoneType::Repel;
+}
+
+constexpr float zoneScale(ZoneType zone) {
+    return zone == ZoneType::Boost   ?  2.0f
+         : zone == ZoneType::Slow    ?  0.3f
+         : zone == ZoneType::Reverse ? -1.0f
+         : 1.0f;
+}
+
+// Scalar reference, used for the tail of each batch
+template <ZoneType Zone>
+inline void accumulateOne(const FieldParams& p, float x, float y, float& fx, float& fy) {
+    float dx = x - p.centerX;
+    float dy = y - p.centerY;
+    float distance = std::sqrt(dx * dx + dy * dy);
+
+    if (distance > p.radius || distance < MIN_DISTANCE) return;
+
+    float falloff = 1.0f - distance / p.radius;
+    falloff = falloff * falloff;
+
+    if constexpr (Zone == ZoneType::Zero) {
+        fy += -9.8f * falloff;
+    } else if constexpr (isRadialZone(Zone)) {
+        float scale = p.strength * falloff / distance;
+        if constexpr (Zone == ZoneType::Attract) scale = -scale;
+        fx += dx * scale;
+        fy += dy * scale;
+    } else {
+        fx += p.pushX * falloff;
+        fy += p.pushY * falloff;
+    }
+}
+
+// Adds the force of four lanes at offset (dx, dy) from their origin: the
+// field center, or the closest point of a path
+template <ZoneType Zone>
+inline void accumulateLanes(const FieldParams& p, Float4 dx, Float4 dy, Float4& fx, Float4& fy) {
+    const Float4 radius = Float4::splat(p.radius);
+    const Float4 radiusSq = Float4::splat(p.radius * p.radius);
+    const Float4 minDistSq = Float4::splat(MIN_DISTANCE * MIN_DISTANCE);
+    const Float4 one = Float4::splat(1.0f);
+
+    Float4 distSq = dx * dx + dy * dy;
+    Float4 inRange = Float4::maskAnd(Float4::lessEqual(distSq, radiusSq),
+                                     Float4::greaterEqual(distSq, minDistSq));
+    if (!Float4::any(inRange)) return;
+
+    Float4 distance = Float4::sqrt(distSq);
+    Float4 falloff = one - distance / radius;
+    falloff = Float4::select(inRange, falloff * falloff);
+
+    if constexpr (Zone == ZoneType::Zero) {
+        fy = fy + falloff * Float4::splat(-9.8f);
+    } else if constexpr (isRadialZone(Zone)) {
+        float signedStrength = Zone == ZoneType::Attract ? -p.strength : p.strength;
+        Float4 safeDistance = Float4::max(distance, Float4::splat(MIN_DISTANCE));
+        Float4 scale = Float4::splat(signedStrength) * falloff / safeDistance;
+        fx = fx + dx * scale;
+        fy = fy + dy * scale;
+    } else {
+        fx = fx + falloff * Float4::splat(p.pushX);
+        fy = fy + falloff * Float4::splat(p.pushY);
+    }
+}
+
+template <ZoneType Zone>
+void accumulateZone(const FieldParams& p, const float* posX, const float* posY,
+                    float* forceX, float* forceY, size_t count) {
+    const Float4 centerX = Float4::splat(p.centerX);
+    const Float4 centerY = Float4::splat(p.centerY);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        Float4 fx = Float4::load(forceX + i);
+        Float4 fy = Float4::load(forceY + i);
+        accumulateLanes<Zone>(p, Float4::load(posX + i) - centerX, Float4::load(posY + i) - centerY, fx, fy);
+        fx.store(forceX + i);
+        fy.store(forceY + i);
+    }
+
+    for (; i < count; ++i) {
+        accumulateOne<Zone>(p, posX[i], posY[i], forceX[i], forceY[i]);
+    }
+}
+
+// Short paths: four positions at a time against every segment, keeping
+// each lane's closest point. Lanes with nothing within the radius end up
+// exactly at the radius and so get no force. Long paths and the tail go
+// through the BVH in GravityField::calculateForce.
+template <ZoneType Zone>
+void accumulatePath(const FieldParams& p, const GravityField& field,
+                    const float* posX, const float* posY,
+                    float* forceX, float* forceY, size_t count) {
+    const std::vector<Vec2>& points = field.getPath().getPoints();
+    const size_t segmentCount = points.size() - 1;
+
+    // Groups entirely outside the path bounds plus the radius are skipped
+    Rect bounds = field.getPath().getBounds();
+    const Float4 minX = Float4::splat(bounds.x - p.radius);
+    const Float4 minY = Float4::splat(bounds.y - p.radius);
+    const Float4 maxX = Float4::splat(bounds.x + bounds.w + p.radius);
+    const Float4 maxY = Float4::splat(bounds.y + bounds.h + p.radius);
+    const Float4 zero = Float4::zero();
+    const Float4 one = Float4::splat(1.0f);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        Float4 px = Float4::load(posX + i);
+        Float4 py = Float4::load(posY + i);
+        Float4 inBounds = Float4::maskAnd(
+            Float4::maskAnd(Float4::greaterEqual(px, minX), Float4::lessEqual(px, maxX)),
+            Float4::maskAnd(Float4::greaterEqual(py, minY), Float4::lessEqual(py, maxY)));
+        if (!Float4::any(inBounds)) continue;
+
+        Float4 bestSq = Float4::splat(p.radius * p.radius);
+        Float4 closestX = px + Float4::splat(p.radius);
+        Float4 closestY = py;
+
+        for (size_t s = 0; s < segmentCount; ++s) {
+            const Vec2& a = points[s];
+            Vec2 ab = points[s + 1] - a;
+            float lengthSq = ab.lengthSquared();
+
+            Float4 ax = Float4::splat(a.x);
+            Float4 ay = Float4::splat(a.y);
+            Float4 abx = Float4::splat(ab.x);
+            Float4 aby = Float4::splat(ab.y);
+
+            Float4 t = zero;
+            if (lengthSq > 0.0f) {
+                t = ((px - ax) * abx + (py - ay) * aby) / Float4::splat(lengthSq);
+                t = Float4::min(Float4::max(t, zero), one);
+            }
+
+            Float4 candidateX = ax + abx * t;
+            Float4 candidateY = ay + aby * t;
+            Float4 dx = px - candidateX;
+            Float4 dy = py - candidateY;
+            Float4 distSq = dx * dx + dy * dy;
+
+            Float4 closer = Float4::lessEqual(distSq, bestSq);
+            bestSq = Float4::blend(closer, distSq, bestSq);
+            closestX = Float4::blend(closer, candidateX, closestX);
+            closestY = Float4::blend(closer, candidateY, closestY);
+        }
+
+        Float4 fx = Float4::load(forceX + i);
+        Float4 fy = Float4::load(forceY + i);
+        accumulateLanes<Zone>(p, px - closestX, py - closestY, fx, fy);
+        fx.store(forceX + i);
+        fy.store(forceY + i);
+    }
+
+    for (; i < count; ++i) {
+        Vec2 force = field.calculateForce(Vec2(posX[i], posY[i]));
+        forceX[i] += force.x;
+        forceY[i] += force.y;
+    }
+}
+
+} // namespace
+
+void accumulateFieldForces(const GravityField& field,
+                           const float* posX, const float* posY,
+                           float* forceX, float* forceY,
+                           size_t count) {
+    if (!field.isActive() || count == 0) return;
+
+    FieldParams p;
+    p.centerX = field.getPosition().x;
+    p.centerY = field.getPosition().y;
+    p.radius = field.getRadius();
+    p.strength = field.getStrength();
+
+    Vec2 push = field.getDirection() * (field.getStrength() * zoneScale(field.getZoneType()));
+    p.pushX = push.x;
+    p.pushY = push.y;
+
+    // Path fields resolve their nearest segment through the stroke's BVH
+    // once the path is too long to test every segment per lane
+    if (field.hasPath()) {
+        if (field.getPath().getSegmentCount() > PATH_KERNEL_MAX_SEGMENTS) {
+            for (size_t i = 0; i < count; ++i) {
+                Vec2 force = field.calculateForce(Vec2(posX[i], posY[i]));
+                forceX[i] += force.x;
+                forceY[i] += force.y;
+            }
+            return;
+        }
+
+        switch (field.getZoneType()) {
+            case ZoneType::Normal:  accumulatePath<ZoneType::Normal>(p, field, posX, posY, forceX, forceY, count); break;
+            case ZoneType::Boost:   accumulatePath<ZoneType::Boost>(p, field, posX, posY, forceX, forceY, count); break;
+            case ZoneType::Slow:    accumulatePath<ZoneType::Slow>(p, field, posX, posY, forceX, forceY, count); break;
+            case ZoneType::Reverse: accumulatePath<ZoneType::Reverse>(p, field, posX, posY, forceX, forceY, count); break;
+            case ZoneType::Attract: accumulatePath<ZoneType::Attract>(p, field, posX, posY, forceX, forceY, count); break;
+            case ZoneType::Repel:   accumulatePath<ZoneType::Repel>(p, field, posX, posY, forceX, forceY, count); break;
+            case ZoneType::Zero:    accumulatePath<ZoneType::Zero>(p, field, posX, posY, forceX, forceY, count); break;
+        }
+        return;
+    }
+
+    switch (field.getZoneType()) {
+        case ZoneType::Normal:  accumulateZone<ZoneType::Normal>(p, posX, posY, forceX, forceY, count); break;
+        case ZoneType::Boost:   accumulateZone<ZoneType::Boost>(p, posX, posY, forceX, forceY, count); break;
+        case ZoneType::Slow:    accumulateZone<ZoneType::Slow>(p, posX, posY, forceX, forceY, count); break;
+        case ZoneType::Reverse: accumulateZone<ZoneType::Reverse>(p, posX, posY, forceX, forceY, count); break;
+        case ZoneType::Attract: accumulateZone<ZoneType::Attract>(p, posX, posY, forceX, forceY, count); break;
+        case ZoneType::Repel:   accumulateZone<ZoneType::Repel>(p, posX, posY, forceX, forceY, count); break;
+        case ZoneType::Zero:    accumulateZone<ZoneType::Zero>(p, posX, posY, forceX, forceY, count); break;
+    }
+}
+
+} // namespace GravityPaint
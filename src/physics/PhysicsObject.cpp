@@ -1,21 +1,58 @@
 #include "GravityPaint/physics/PhysicsObject.h"
+#include "GravityPaint/physics/WorldSnapshot.h"
 #include "GravityPaint/Constants.h"
 #include <cmath>
 #include <algorithm>
 
 namespace GravityPaint {
 
-int PhysicsObject::s_nextId = 1;
+std::atomic<int> PhysicsObject::s_nextId{1};
 
 PhysicsObject::PhysicsObject(b2World* world, ObjectType type, const Vec2& position, float size)
     : m_type(type)
     , m_size(size)
     , m_id(s_nextId++)
 {
-    createBody(world, position);
+    m_body = world ? buildBody(world, type, position, size, true) : nullptr;
+    if (m_body) {
+        m_body->GetUserData().pointer = reinterpret_cast<uintptr_t>(this);
+        storePreviousTransform();
+    }
+    initColor();
+}
 
+PhysicsObject::PhysicsObject(b2Body* pooledBody, float bodySize, ObjectType type, const Vec2& position, float size)
+    : m_body(pooledBody)
+    , m_type(type)
+    , m_size(size)
+    , m_id(s_nextId++)
+{
+    if (bodySize != size) {
+        while (b2Fixture* fixture = m_body->GetFixtureList()) {
+            m_body->DestroyFixture(fixture);
+        }
+        buildFixture(m_body, type, size);
+    }
+
+    // The previous owner may have been frozen
+    if (m_body->GetType() != b2_dynamicBody) {
+        m_body->SetType(b2_dynamicBody);
+    }
+
+    // Transform first so the re-enabled proxies are created in place
+    m_body->SetTransform(b2Vec2(position.x / PHYSICS_SCALE, position.y / PHYSICS_SCALE), 0.0f);
+    m_body->SetLinearVelocity(b2Vec2(0.0f, 0.0f));
+    m_body->SetAngularVelocity(0.0f);
+    m_body->GetUserData().pointer = reinterpret_cast<uintptr_t>(this);
+    m_body->SetEnabled(true);
+    m_body->SetAwake(true);
+    storePreviousTransform();
+    initColor();
+}
+
+void PhysicsObject::initColor() {
     // Set color based on type
-    switch (type) {
+    switch (m_type) {
         case ObjectType::Ball:
             m_color = Color::cyan();
             break;
@@ -35,27 +72,71 @@ PhysicsObject::PhysicsObject(b2World* world, ObjectType type, const Vec2& positi
 }
 
 PhysicsObject::~PhysicsObject() {
+    destroyBody();
+}
+
+PhysicsObject::PhysicsObject(PhysicsObject&& other) noexcept
+    : m_type(other.m_type)
+    , m_size(other.m_size)
+    , m_id(other.m_id)
+{
+    *this = std::move(other);
+}
+
+PhysicsObject& PhysicsObject::operator=(PhysicsObject&& other) noexcept {
+    if (this == &other) return *this;
+
+    destroyBody();
+
+    m_body = other.m_body;
+    other.m_body = nullptr;
+    if (m_body) {
+        m_body->GetUserData().pointer = reinterpret_cast<uintptr_t>(this);
+    }
+
+    m_type = other.m_type;
+    m_size = other.m_size;
+    m_id = other.m_id;
+    m_energy = other.m_energy;
+    m_color = other.m_color;
+    m_trail = std::move(other.m_trail);
+    m_trailTimer = other.m_trailTimer;
+    m_previousPosition = other.m_previousPosition;
+    m_previousAngle = other.m_previousAngle;
+    m_active = other.m_active;
+    m_goalOverlaps = other.m_goalOverlaps;
+    m_collected = other.m_collected;
+    m_reachedGoal = other.m_reachedGoal;
+    m_frozen = other.m_frozen;
+    m_fieldForce = other.m_fieldForce;
+    m_reducedRate = other.m_reducedRate;
+    return *this;
+}
+
+void PhysicsObject::destroyBody() {
     if (m_body && m_body->GetWorld()) {
         m_body->GetWorld()->DestroyBody(m_body);
     }
+    m_body = nullptr;
 }
 
-void PhysicsObject::createBody(b2World* world, const Vec2& position) {
-    if (!world) return;
-
+b2Body* PhysicsObject::buildBody(b2World* world, ObjectType type, const Vec2& position, float size, bool enabled) {
     b2BodyDef bodyDef;
     bodyDef.type = b2_dynamicBody;
     bodyDef.position = b2Vec2(position.x / PHYSICS_SCALE, position.y / PHYSICS_SCALE);
     bodyDef.linearDamping = 0.5f;
     bodyDef.angularDamping = 0.3f;
+    bodyDef.enabled = enabled;
 
-    m_body = world->CreateBody(&bodyDef);
-    if (!m_body) return;
-    
-    b2BodyUserData& userData = m_body->GetUserData();
-    userData.pointer = reinterpret_cast<uintptr_t>(this);
+    b2Body* body = world->CreateBody(&bodyDef);
+    if (body) {
+        buildFixture(body, type, size);
+    }
+    return body;
+}
 
-    float scaledSize = m_size * 20.0f / PHYSICS_SCALE;
+void PhysicsObject::buildFixture(b2Body* body, ObjectType type, float size) {
+    float scaledSize = size * 20.0f / PHYSICS_SCALE;
 
     // Create shapes outside switch to avoid scope issues
     b2CircleShape circleShape;
@@ -66,7 +147,7 @@ void PhysicsObject::createBody(b2World* world, const Vec2& position) {
     fixtureDef.friction = 0.3f;
     fixtureDef.restitution = 0.6f;
 
-    switch (m_type) {
+    switch (type) {
         case ObjectType::Ball:
         case ObjectType::Blob:
             circleShape.m_radius = scaledSize;
@@ -101,7 +182,19 @@ void PhysicsObject::createBody(b2World* world, const Vec2& position) {
         }
     }
 
-    m_body->CreateFixture(&fixtureDef);
+    body->CreateFixture(&fixtureDef);
+}
+
+b2Body* PhysicsObject::releaseBody() {
+    b2Body* body = m_body;
+    if (!body) return nullptr;
+
+    // Disabling ends the body's contacts (goal sensors included) while
+    // the user data still points here
+    body->SetEnabled(false);
+    body->GetUserData().pointer = 0;
+    m_body = nullptr;
+    return body;
 }
 
 void PhysicsObject::update(float deltaTime) {
@@ -129,9 +222,9 @@ void PhysicsObject::updateTrail() {
     }
 }
 
-void PhysicsObject::applyForce(const Vec2& force) {
+void PhysicsObject::applyForce(const Vec2& force, bool wake) {
     if (m_body) {
-        m_body->ApplyForceToCenter(b2Vec2(force.x, force.y), true);
+        m_body->ApplyForceToCenter(b2Vec2(force.x, force.y), wake);
     }
 }
 
@@ -156,6 +249,7 @@ Vec2 PhysicsObject::getPosition() const {
 void PhysicsObject::setPosition(const Vec2& position) {
     if (m_body) {
         m_body->SetTransform(b2Vec2(position.x / PHYSICS_SCALE, position.y / PHYSICS_SCALE), m_body->GetAngle());
+        storePreviousTransform();  // Teleports must not be interpolated
     }
 }
 
@@ -173,6 +267,7 @@ float PhysicsObject::getAngle() const {
 void PhysicsObject::setAngle(float angle) {
     if (m_body) {
         m_body->SetTransform(m_body->GetPosition(), angle);
+        storePreviousTransform();
     }
 }
 
@@ -181,6 +276,20 @@ float PhysicsObject::getAngularVelocity() const {
     return m_body->GetAngularVelocity();
 }
 
+void PhysicsObject::storePreviousTransform() {
+    m_previousPosition = getPosition();
+    m_previousAngle = getAngle();
+}
+
+Vec2 PhysicsObject::getInterpolatedPosition(float alpha) const {
+    return Vec2::lerp(m_previousPosition, getPosition(), alpha);
+}
+
+float PhysicsObject::getInterpolatedAngle(float alpha) const {
+    // Box2D angles are unwound, so a plain lerp takes the short way round
+    return m_previousAngle + (getAngle() - m_previousAngle) * alpha;
+}
+
 float PhysicsObject::getMass() const {
     if (!m_body) return 1.0f;
     return m_body->GetMass();
@@ -215,6 +324,83 @@ Color PhysicsObject::getEnergyColor() const {
     }
 }
 
+void PhysicsObject::fillSnapshot(ObjectSnapshot& snapshot, float alpha) const {
+    snapshot.id = m_id;
+    snapshot.type = m_type;
+    snapshot.position = getInterpolatedPosition(alpha);
+    snapshot.angle = getInterpolatedAngle(alpha);
+    snapshot.size = m_size;
+    snapshot.energy = m_energy;
+    snapshot.color = m_color;
+    snapshot.energyColor = getEnergyColor();
+    snapshot.active = m_active;
+    snapshot.reachedGoal = m_reachedGoal;
+    snapshot.trail.assign(m_trail.begin(), m_trail.end());
+}
+
+void PhysicsObject::captureState(ObjectState& state, std::vector<Vec2>& trails) const {
+    state.id = m_id;
+    if (m_body) {
+        state.position = m_body->GetPosition();
+        state.angle = m_body->GetAngle();
+        state.linearVelocity = m_body->GetLinearVelocity();
+        state.angularVelocity = m_body->GetAngularVelocity();
+        state.awake = m_body->IsAwake();
+    }
+    state.previousPosition = m_previousPosition;
+    state.previousAngle = m_previousAngle;
+    state.energy = m_energy;
+    state.trailTimer = m_trailTimer;
+    state.trailOffset = static_cast<uint32_t>(trails.size());
+    state.trailCount = static_cast<uint32_t>(m_trail.size());
+    trails.insert(trails.end(), m_trail.begin(), m_trail.end());
+    state.active = m_active;
+    state.collected = m_collected;
+    state.reachedGoal = m_reachedGoal;
+    state.frozen = m_frozen;
+}
+
+void PhysicsObject::restoreState(const ObjectState& state, const std::vector<Vec2>& trails) {
+    if (m_body) {
+        m_body->SetType(state.frozen ? b2_staticBody : b2_dynamicBody);
+        m_body->SetTransform(state.position, state.angle);
+        m_body->SetLinearVelocity(state.linearVelocity);
+        m_body->SetAngularVelocity(state.angularVelocity);
+        m_body->SetEnabled(state.active);
+        m_body->SetAwake(state.awake);
+    }
+    m_previousPosition = state.previousPosition;
+    m_previousAngle = state.previousAngle;
+    m_energy = state.energy;
+    m_trailTimer = state.trailTimer;
+    m_trail.assign(trails.begin() + state.trailOffset,
+                   trails.begin() + state.trailOffset + state.trailCount);
+    m_active = state.active;
+    m_collected = state.collected;
+    m_reachedGoal = state.reachedGoal;
+    m_frozen = state.frozen;
+    m_fieldForce = Vec2(0, 0);
+    m_reducedRate = false;
+}
+
+void PhysicsObject::freeze() {
+    if (m_frozen || !m_body) return;
+    m_body->SetType(b2_staticBody);
+    m_frozen = true;
+}
+
+void PhysicsObject::exitGoal() {
+    if (m_goalOverlaps > 0) {
+        m_goalOverlaps--;
+    }
+}
+
+bool PhysicsObject::reachGoal() {
+    if (m_reachedGoal) return false;
+    m_reachedGoal = true;
+    return true;
+}
+
 void PhysicsObject::setActive(bool active) {
     m_active = active;
     if (m_body) {
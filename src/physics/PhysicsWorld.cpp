@@ -2,53 +2,283 @@
 #include "GravityPaint/physics/GravityField.h"
 #include "GravityPaint/physics/PhysicsObject.h"
 #include "GravityPaint/physics/DeformableSurface.h"
+#include "GravityPaint/physics/GravityKernel.h"
 #include "GravityPaint/Constants.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
 
 namespace GravityPaint {
 
+namespace {
+
+// Fixture user data marking goal zone sensors
+constexpr uintptr_t GOAL_SENSOR_TAG = 1;
+
+// Records a (field proxy, position index) pair for every field whose AABB
+// overlaps the query box
+struct FieldQuery {
+    std::vector<std::pair<int32, int32>>* pairs;
+    int32 index;
+
+    bool QueryCallback(int32 proxyId) {
+        pairs->emplace_back(proxyId, index);
+        return true;
+    }
+};
+
+// Obstacle shape centered at center (meters) in body space
+void addObstacleFixture(b2Body* body, const b2Vec2& center, const Vec2& size, float rotation, bool circle) {
+    b2PolygonShape box;
+    b2CircleShape disc;
+
+    b2FixtureDef fixtureDef;
+    fixtureDef.friction = 0.3f;
+    fixtureDef.restitution = 0.5f;
+
+    if (circle) {
+        disc.m_p = center;
+        disc.m_radius = size.x / 2 / PHYSICS_SCALE;
+        fixtureDef.shape = &disc;
+    } else {
+        box.SetAsBox(size.x / 2 / PHYSICS_SCALE, size.y / 2 / PHYSICS_SCALE, center, rotation);
+        fixtureDef.shape = &box;
+    }
+
+    body->CreateFixture(&fixtureDef);
+}
+
+PhysicsObject* objectFromFixture(b2Fixture* fixture) {
+    return reinterpret_cast<PhysicsObject*>(fixture->GetBody()->GetUserData().pointer);
+}
+
+// First object fixture containing the point
+struct PointQuery : public b2QueryCallback {
+    b2Vec2 point;
+    PhysicsObject* hit = nullptr;
+
+    bool ReportFixture(b2Fixture* fixture) override {
+        if (fixture->IsSensor()) return true;
+        PhysicsObject* object = objectFromFixture(fixture);
+        if (object && fixture->TestPoint(point)) {
+            hit = object;
+            return false;
+        }
+        return true;
+    }
+};
+
+// Every point inside a fixture's bounds and not yet resolved is tested
+// against it. Points are sorted by x, so each fixture only scans the ones
+// in its own column.
+struct PointBatchQuery : public b2QueryCallback {
+    const b2Vec2* points = nullptr;
+    const uint32_t* order = nullptr;
+    size_t count = 0;
+    size_t remaining = 0;
+    PhysicsObject** results = nullptr;
+
+    bool ReportFixture(b2Fixture* fixture) override {
+        if (fixture->IsSensor()) return true;
+        PhysicsObject* object = objectFromFixture(fixture);
+        if (!object) return true;
+
+        const b2AABB& bounds = fixture->GetAABB(0);
+        const b2Vec2* end = points + count;
+        const b2Vec2* it = std::lower_bound(points, end, bounds.lowerBound.x,
+                                            [](const b2Vec2& p, float x) { return p.x < x; });
+        for (; it != end && it->x <= bounds.upperBound.x; ++it) {
+            PhysicsObject*& result = results[order[it - points]];
+            if (result || it->y < bounds.lowerBound.y || it->y > bounds.upperBound.y) continue;
+            if (fixture->TestPoint(*it)) {
+                result = object;
+                if (--remaining == 0) return false;
+            }
+        }
+        return true;
+    }
+};
+
+// Objects whose center is inside the area. Objects have a single fixture,
+// so each is reported at most once.
+struct AreaQuery : public b2QueryCallback {
+    Rect area;
+    PhysicsObject** results = nullptr;
+    size_t capacity = 0;
+    size_t count = 0;
+
+    bool ReportFixture(b2Fixture* fixture) override {
+        if (fixture->IsSensor()) return true;
+        PhysicsObject* object = objectFromFixture(fixture);
+        if (object && area.contains(object->getPosition())) {
+            if (count < capacity) {
+                results[count] = object;
+            }
+            count++;
+        }
+        return true;
+    }
+};
+
+// Clips the ray to the nearest non-sensor fixture seen so far
+struct RayQuery : public b2RayCastCallback {
+    b2Fixture* fixture = nullptr;
+    b2Vec2 point = b2Vec2(0.0f, 0.0f);
+    b2Vec2 normal = b2Vec2(0.0f, 0.0f);
+    float fraction = 1.0f;
+
+    float ReportFixture(b2Fixture* hitFixture, const b2Vec2& hitPoint,
+                        const b2Vec2& hitNormal, float hitFraction) override {
+        if (hitFixture->IsSensor()) return -1.0f;
+        fixture = hitFixture;
+        point = hitPoint;
+        normal = hitNormal;
+        fraction = hitFraction;
+        return hitFraction;
+    }
+};
+
+} // namespace
+
 void ContactListener::BeginContact(b2Contact* contact) {
+    if (handleGoalSensor(contact, true)) return;
+    push(contact, 0.0f, true);
+}
+
+void ContactListener::EndContact(b2Contact* contact) {
+    handleGoalSensor(contact, false);
+}
+
+bool ContactListener::handleGoalSensor(b2Contact* contact, bool began) {
     b2Fixture* fixtureA = contact->GetFixtureA();
     b2Fixture* fixtureB = contact->GetFixtureB();
 
-    void* userDataA = reinterpret_cast<void*>(fixtureA->GetBody()->GetUserData().pointer);
-    void* userDataB = reinterpret_cast<void*>(fixtureB->GetBody()->GetUserData().pointer);
+    b2Fixture* other = nullptr;
+    if (fixtureA->GetUserData().pointer == GOAL_SENSOR_TAG) {
+        other = fixtureB;
+    } else if (fixtureB->GetUserData().pointer == GOAL_SENSOR_TAG) {
+        other = fixtureA;
+    } else {
+        return false;
+    }
 
-    if (m_callback && userDataA && userDataB) {
-        m_callback(static_cast<PhysicsObject*>(userDataA), static_cast<PhysicsObject*>(userDataB));
+    auto* object = reinterpret_cast<PhysicsObject*>(other->GetBody()->GetUserData().pointer);
+    if (object) {
+        if (began) {
+            m_world->onGoalEnter(object);
+        } else {
+            m_world->onGoalExit(object);
+        }
     }
+    return true;
 }
 
-void ContactListener::EndContact(b2Contact* /*contact*/) {}
-
 void ContactListener::PreSolve(b2Contact* /*contact*/, const b2Manifold* /*oldManifold*/) {}
 
 void ContactListener::PostSolve(b2Contact* contact, const b2ContactImpulse* impulse) {
-    // Energy transfer on collision
     float totalImpulse = 0;
     for (int i = 0; i < impulse->count; ++i) {
         totalImpulse += impulse->normalImpulses[i];
     }
+    push(contact, totalImpulse, false);
+}
 
-    if (totalImpulse > 1.0f) {
-        b2Fixture* fixtureA = contact->GetFixtureA();
-        b2Fixture* fixtureB = contact->GetFixtureB();
+void ContactListener::push(b2Contact* contact, float normalImpulse, bool began) {
+    void* userDataA = reinterpret_cast<void*>(contact->GetFixtureA()->GetBody()->GetUserData().pointer);
+    void* userDataB = reinterpret_cast<void*>(contact->GetFixtureB()->GetBody()->GetUserData().pointer);
+    if (!userDataA || !userDataB) return;
+
+    auto* a = static_cast<PhysicsObject*>(userDataA);
+    auto* b = static_cast<PhysicsObject*>(userDataB);
+
+    b2WorldManifold manifold;
+    contact->GetWorldManifold(&manifold);
+    int pointCount = contact->GetManifold()->pointCount;
+    b2Vec2 point = pointCount > 1 ? 0.5f * (manifold.points[0] + manifold.points[1])
+                 : pointCount == 1 ? manifold.points[0]
+                 : 0.5f * (a->getBody()->GetPosition() + b->getBody()->GetPosition());
+    record(a, b, point, normalImpulse, began);
+}
 
-        void* userDataA = reinterpret_cast<void*>(fixtureA->GetBody()->GetUserData().pointer);
-        void* userDataB = reinterpret_cast<void*>(fixtureB->GetBody()->GetUserData().pointer);
+size_t ContactListener::pairSlot(const PhysicsObject* a, const PhysicsObject* b) const {
+    // Fibonacci hash of the id pair
+    uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(a->getId())) << 32) |
+                   static_cast<uint32_t>(b->getId());
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & (m_pairTable.size() - 1);
+}
 
-        if (userDataA && userDataB) {
-            PhysicsObject* objA = static_cast<PhysicsObject*>(userDataA);
-            PhysicsObject* objB = static_cast<PhysicsObject*>(userDataB);
+void ContactListener::reserve(size_t pairCount) {
+    size_t capacity = std::max(pairCount, static_cast<size_t>(CONTACT_EVENT_CAPACITY));
+    if (capacity <= m_capacity) return;
+
+    // Grow by at least half so a slowly rising contact count doesn't
+    // reallocate every tick. The table stays at most half full, so a probe
+    // always reaches an empty slot.
+    m_capacity = std::max(capacity, m_capacity + m_capacity / 2);
+    m_records.reserve(m_capacity);
+    m_recordSlot.reserve(m_capacity);
+    size_t tableSize = 1;
+    while (tableSize < 2 * m_capacity) {
+        tableSize <<= 1;
+    }
+    m_pairTable.assign(tableSize, -1);
 
-            // Transfer energy based on impact
-            float transfer = std::min(totalImpulse * 0.1f, 10.0f);
-            if (objA->getEnergy() > objB->getEnergy()) {
-                objA->transferEnergy(objB, transfer * ENERGY_TRANSFER_RATE);
-            } else {
-                objB->transferEnergy(objA, transfer * ENERGY_TRANSFER_RATE);
+    // Rehash anything recorded so far
+    for (size_t i = 0; i < m_records.size(); ++i) {
+        size_t slot = pairSlot(m_records[i].a, m_records[i].b);
+        while (m_pairTable[slot] >= 0) {
+            slot = (slot + 1) & (tableSize - 1);
+        }
+        m_pairTable[slot] = static_cast<int32_t>(i);
+        m_recordSlot[i] = static_cast<uint32_t>(slot);
+    }
+}
+
+void ContactListener::record(PhysicsObject* a, PhysicsObject* b, const b2Vec2& point,
+                             float normalImpulse, bool began) {
+    if (a->getId() > b->getId()) {
+        std::swap(a, b);
+    }
+
+    const size_t mask = m_pairTable.size() - 1;
+    size_t slot = pairSlot(a, b);
+    for (; m_pairTable[slot] >= 0; slot = (slot + 1) & mask) {
+        Record& existing = m_records[static_cast<size_t>(m_pairTable[slot])];
+        if (existing.a == a && existing.b == b) {
+            existing.began = existing.began || began;
+            if (normalImpulse > existing.normalImpulse) {
+                existing.normalImpulse = normalImpulse;
+                existing.point = point;
             }
+            return;
         }
     }
+
+    if (m_records.size() == m_capacity) {
+        m_dropped++;
+        return;
+    }
+
+    Record entry;
+    entry.a = a;
+    entry.b = b;
+    entry.point = point;
+    entry.normalImpulse = normalImpulse;
+    entry.began = began;
+    entry.sequence = static_cast<uint32_t>(m_records.size());
+    m_pairTable[slot] = static_cast<int32_t>(m_records.size());
+    m_recordSlot.push_back(static_cast<uint32_t>(slot));
+    m_records.push_back(entry);
+}
+
+void ContactListener::clear() {
+    for (uint32_t slot : m_recordSlot) {
+        m_pairTable[slot] = -1;
+    }
+    m_records.clear();
+    m_recordSlot.clear();
+    m_dropped = 0;
 }
 
 PhysicsWorld::PhysicsWorld() = default;
@@ -60,18 +290,27 @@ PhysicsWorld::~PhysicsWorld() {
 bool PhysicsWorld::initialize() {
     b2Vec2 gravity(m_globalGravity.x, m_globalGravity.y);
     m_world = std::make_unique<b2World>(gravity);
+    m_fieldTree = std::make_unique<b2DynamicTree>();
 
-    m_contactListener = std::make_unique<ContactListener>();
+    m_contactListener = std::make_unique<ContactListener>(this);
     m_world->SetContactListener(m_contactListener.get());
+    m_contactEvents.reserve(CONTACT_EVENT_CAPACITY);
 
     return true;
 }
 
 void PhysicsWorld::shutdown() {
-    clearObjects();
+    // Pooled bodies go down with the world
+    for (auto& pool : m_bodyPool) {
+        pool.clear();
+    }
+    m_objects.clear();
+    m_goalCount = 0;
     clearGravityFields();
+    clearGravityZones();
     m_deformableSurfaces.clear();
     destroyBoundaries();
+    clearGoalZones();
 
     for (auto* body : m_staticBodies) {
         if (m_world) {
@@ -79,6 +318,7 @@ void PhysicsWorld::shutdown() {
         }
     }
     m_staticBodies.clear();
+    clearObstacles();
 
     m_contactListener.reset();
     m_world.reset();
@@ -87,144 +327,553 @@ void PhysicsWorld::shutdown() {
 void PhysicsWorld::update(float deltaTime) {
     if (!m_world) return;
 
-    // Apply custom gravity fields
-    applyGravityFields();
+    if (deltaTime > MAX_FRAME_DELTA) {
+        m_stepStats.droppedTime += deltaTime - MAX_FRAME_DELTA;
+        deltaTime = MAX_FRAME_DELTA;
+    }
+
+    // Fixed timestep physics, within the step budget
+    auto start = std::chrono::steady_clock::now();
+    int substeps = 0;
 
-    // Fixed timestep physics
     m_accumulator += deltaTime;
-    while (m_accumulator >= FIXED_TIMESTEP) {
-        m_world->Step(FIXED_TIMESTEP, PHYSICS_VELOCITY_ITERATIONS, PHYSICS_POSITION_ITERATIONS);
-        m_accumulator -= FIXED_TIMESTEP;
+    while (m_accumulator >= m_timestep) {
+        bool overBudget = substeps >= m_maxSubsteps;
+        if (!overBudget && substeps > 0 && m_stepBudget > 0.0f) {
+            float elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+            overBudget = elapsed >= m_stepBudget;
+        }
+
+        if (overBudget) {
+            // Slow the simulation down instead of queueing the backlog;
+            // the sub-tick remainder is kept for interpolation
+            float remainder = std::fmod(m_accumulator, m_timestep);
+            m_stepStats.dilatedTime += m_accumulator - remainder;
+            m_stepStats.dilatedUpdates++;
+            m_accumulator = remainder;
+            break;
+        }
+
+        stepTick();
+        m_accumulator -= m_timestep;
+        substeps++;
+    }
+
+    m_stepStats.ticks += substeps;
+    m_stepStats.updates++;
+    m_stepStats.lastSubsteps = substeps;
+}
+
+void PhysicsWorld::setStepBudget(int maxSubsteps, float maxSeconds) {
+    m_maxSubsteps = std::max(1, maxSubsteps);
+    m_stepBudget = maxSeconds;
+}
+
+void PhysicsWorld::stepTick() {
+    // Gameplay hooks run at tick boundaries so a replay sees the same order
+    if (m_preTick) {
+        m_preTick(m_tick, m_timestep);
+    }
+
+    for (auto& obj : m_objects) {
+        obj.storePreviousTransform();
     }
 
+    // Force stage: Box2D clears applied forces after every Step, so custom
+    // gravity has to be re-applied each tick or extra ticks in a long frame
+    // would fall under plain world gravity
+    applyGravityFields();
+    updateMovers();
+
+    // Every pair the step reports is a Box2D contact, and all but the few
+    // TOI adds exist before it starts. Room for each keeps records from
+    // being dropped without allocating inside the solver.
+    m_contactListener->reserve(static_cast<size_t>(m_world->GetContactCount()));
+    m_world->Step(m_timestep, PHYSICS_VELOCITY_ITERATIONS, PHYSICS_POSITION_ITERATIONS);
+
+    const b2Profile& profile = m_world->GetProfile();
+    m_stepStats.collideMs += profile.collide;
+    m_stepStats.solveMs += profile.solve;
+
+    // Contacts recorded during the step are applied here, outside the solver
+    drainContacts();
+    updateGoalObjects();
+
     // Update objects
     for (auto& obj : m_objects) {
-        if (obj->isActive()) {
-            obj->update(deltaTime);
-
-            // Check if in goal zone
-            if (m_hasGoalZone) {
-                Vec2 pos = obj->getPosition();
-                if (m_goalZone.contains(pos)) {
-                    obj->setInGoal(true);
-                }
-            }
+        if (obj.isActive()) {
+            obj.update(m_timestep);
         }
     }
 
     // Update deformable surfaces
-    updateDeformableSurfaces(deltaTime);
+    updateDeformableSurfaces(m_timestep);
 
-    // Update gravity fields
-    for (auto it = m_gravityFields.begin(); it != m_gravityFields.end();) {
-        (*it)->update(deltaTime);
-        if ((*it)->isExpired()) {
-            it = m_gravityFields.erase(it);
+    // Fade painted gravity
+    if (m_gravityMode == GravityMode::Paint) {
+        m_paintGrid.decay(m_timestep, PAINT_FIELD_DECAY_RATE);
+        m_paintGrid.diffuse(m_timestep, m_paintDiffusion);
+    }
+
+    // Update gravity fields; removal moves the last field into slot i
+    for (size_t i = 0; i < m_gravityFields.size();) {
+        GravityField& field = m_gravityFields[i];
+        field.update(m_timestep);
+        if (field.isExpired()) {
+            destroyFieldProxy(field);
+            m_gravityFields.remove(m_gravityFields.handleAt(i));
         } else {
-            ++it;
+            ++i;
         }
     }
+
+    if (m_postTick) {
+        m_postTick(m_tick, m_timestep);
+    }
+    m_tick++;
+}
+
+void PhysicsWorld::drainContacts() {
+    m_stepStats.droppedContacts += m_contactListener->getDroppedCount();
+
+    std::vector<ContactListener::Record>& records = m_contactListener->getRecords();
+    if (records.empty()) {
+        m_contactEvents.clear();
+        m_contactListener->clear();
+        return;
+    }
+
+    mergeContacts(records, m_tick, m_contactEvents);
+    m_contactListener->clear();
+
+    if (m_contactCallback) {
+        m_contactCallback(m_contactEvents);
+    }
+}
+
+void PhysicsWorld::mergeContacts(std::vector<ContactListener::Record>& records, uint64_t tick,
+                                 std::vector<ContactEvent>& events) {
+    events.clear();
+    for (size_t i = 0; i < records.size(); ++i) {
+        ContactListener::Record& record = records[i];
+        if (record.a->getId() > record.b->getId()) {
+            std::swap(record.a, record.b);
+        }
+        record.sequence = static_cast<uint32_t>(i);
+    }
+
+    // The listener already keeps one record per pair, but records fed in
+    // directly may repeat one. Ties break on input order, which keeps the
+    // result deterministic without the buffer std::stable_sort allocates.
+    std::sort(records.begin(), records.end(),
+              [](const ContactListener::Record& x, const ContactListener::Record& y) {
+        if (x.a->getId() != y.a->getId()) return x.a->getId() < y.a->getId();
+        if (x.b->getId() != y.b->getId()) return x.b->getId() < y.b->getId();
+        return x.sequence < y.sequence;
+    });
+
+    for (size_t i = 0; i < records.size();) {
+        const ContactListener::Record& first = records[i];
+        ContactEvent event;
+        event.idA = first.a->getId();
+        event.idB = first.b->getId();
+        event.point = toPixels(first.point);
+        event.tick = tick;
+
+        size_t j = i;
+        for (; j < records.size() && records[j].a == first.a && records[j].b == first.b; ++j) {
+            const ContactListener::Record& rec = records[j];
+            event.began = event.began || rec.began;
+            if (rec.normalImpulse > event.normalImpulse) {
+                event.normalImpulse = rec.normalImpulse;
+                event.point = toPixels(rec.point);
+            }
+        }
+
+        // Energy flows from the more charged object, scaled by the impact
+        if (event.normalImpulse > CONTACT_IMPULSE_THRESHOLD) {
+            float transfer = std::min(event.normalImpulse * 0.1f, 10.0f) * ENERGY_TRANSFER_RATE;
+            if (first.a->getEnergy() > first.b->getEnergy()) {
+                first.a->transferEnergy(first.b, transfer);
+            } else {
+                first.b->transferEnergy(first.a, transfer);
+            }
+        }
+
+        events.push_back(event);
+        i = j;
+    }
 }
 
 void PhysicsWorld::reset() {
     clearObjects();
     clearGravityFields();
+    clearGravityZones();
+    m_paintGrid.clear();
 
     for (auto& surface : m_deformableSurfaces) {
-        surface->reset();
+        surface.reset();
     }
 
+    m_contactEvents.clear();
     m_accumulator = 0.0f;
+    m_tick = 0;
+    syncMovers();
 }
 
-PhysicsObject* PhysicsWorld::createObject(ObjectType type, const Vec2& position, float size) {
-    if (!m_world) return nullptr;
-    
-    auto obj = std::make_unique<PhysicsObject>(m_world.get(), type, position, size);
-    if (!obj || !obj->getBody()) return nullptr;
-    
-    PhysicsObject* ptr = obj.get();
-    m_objects.push_back(std::move(obj));
-    return ptr;
+void PhysicsWorld::captureSnapshot(WorldSnapshot& snapshot) const {
+    snapshot.objects.resize(m_objects.size());
+    snapshot.trails.clear();
+    for (size_t i = 0; i < m_objects.size(); ++i) {
+        m_objects[i].captureState(snapshot.objects[i], snapshot.trails);
+    }
+
+    snapshot.fields.resize(m_gravityFields.size());
+    for (size_t i = 0; i < m_gravityFields.size(); ++i) {
+        m_gravityFields[i].captureState(snapshot.fields[i]);
+        snapshot.fields[i].handle = m_gravityFields.handleAt(i);
+    }
+
+    snapshot.paintGrid = m_paintGrid;
+    snapshot.accumulator = m_accumulator;
+    snapshot.tick = m_tick;
+    snapshot.valid = true;
 }
 
-void PhysicsWorld::destroyObject(PhysicsObject* object) {
-    for (auto it = m_objects.begin(); it != m_objects.end(); ++it) {
-        if (it->get() == object) {
-            m_objects.erase(it);
-            return;
+bool PhysicsWorld::restoreSnapshot(const WorldSnapshot& snapshot) {
+    if (!snapshot.valid || !m_world) return false;
+    if (m_objects.size() < snapshot.objects.size()) return false;
+    if (m_gravityFields.size() < snapshot.fields.size()) return false;
+
+    // Captured objects must still sit at their captured index. Removing an
+    // object moves the last one into its hole, so after a removal the ids
+    // stop matching and restore fails, leaving the caller to respawn.
+    for (size_t i = 0; i < snapshot.objects.size(); ++i) {
+        if (m_objects[i].getId() != snapshot.objects[i].id) return false;
+    }
+
+    // Fields expire and are released mid-level, and removal moves the last
+    // field into the hole, so they are matched by handle instead
+    for (const auto& state : snapshot.fields) {
+        if (!m_gravityFields.contains(state.handle)) return false;
+    }
+
+    // Drop anything spawned or bound since the capture
+    while (m_objects.size() > snapshot.objects.size()) {
+        recycleBody(m_objects.back());
+        m_objects.remove(m_objects.handleAt(m_objects.size() - 1));
+    }
+    // Walking back to front, a removal only moves in a field already kept.
+    // Snapshots hold a few dozen fields at most, so a linear search is fine.
+    for (size_t i = m_gravityFields.size(); i-- > 0;) {
+        FieldHandle handle = m_gravityFields.handleAt(i);
+        bool captured = std::any_of(snapshot.fields.begin(), snapshot.fields.end(),
+                                    [&](const FieldState& state) { return state.handle == handle; });
+        if (!captured) {
+            destroyFieldProxy(m_gravityFields[i]);
+            m_gravityFields.remove(handle);
+        }
+    }
+
+    // Sensor overlaps follow Box2D's contacts, which survive the restore;
+    // only the sticky reached flags come from the snapshot
+    m_goalCount = 0;
+    for (size_t i = 0; i < snapshot.objects.size(); ++i) {
+        m_objects[i].restoreState(snapshot.objects[i], snapshot.trails);
+        if (m_objects[i].hasReachedGoal()) {
+            m_goalCount++;
+        }
+    }
+
+    for (const auto& state : snapshot.fields) {
+        GravityField* field = m_gravityFields.get(state.handle);
+        field->restoreState(state);
+        refreshFieldProxy(*field);
+    }
+
+    for (auto& surface : m_deformableSurfaces) {
+        surface.reset();
+    }
+
+    m_paintGrid = snapshot.paintGrid;
+    m_accumulator = snapshot.accumulator;
+    m_tick = snapshot.tick;
+    syncMovers();
+    m_lodRefresh = true;
+    m_world->ClearForces();
+    m_contactEvents.clear();
+    return true;
+}
+
+void PhysicsWorld::setTickRate(int hz) {
+    static constexpr int rates[] = {30, 60, 120, 240};
+
+    int best = rates[0];
+    for (int rate : rates) {
+        if (std::abs(rate - hz) < std::abs(best - hz)) {
+            best = rate;
         }
     }
+
+    m_tickRate = best;
+    m_timestep = 1.0f / best;
+
+    // Don't carry more than one new tick of backlog across the switch
+    m_accumulator = std::min(m_accumulator, m_timestep);
+
+    // Mover paths are sampled per tick; updateMovers steers each mover
+    // onto its resampled path over the next tick
+    rebuildMoverPaths();
+}
+
+ObjectHandle PhysicsWorld::createObject(ObjectType type, const Vec2& position, float size) {
+    if (!m_world) return ObjectHandle();
+
+    auto start = std::chrono::steady_clock::now();
+    auto& pool = m_bodyPool[static_cast<size_t>(type)];
+    bool pooled = !pool.empty();
+
+    ObjectHandle handle;
+    if (pooled) {
+        // Prefer a body built at this size so its fixture can stay
+        size_t pick = pool.size() - 1;
+        for (size_t i = pool.size(); i-- > 0;) {
+            if (pool[i].size == size) {
+                pick = i;
+                break;
+            }
+        }
+        PooledBody entry = pool[pick];
+        pool[pick] = pool.back();
+        pool.pop_back();
+
+        if (entry.size != size) {
+            m_poolStats.fixtureRebuilds++;
+        }
+        handle = m_objects.emplace(entry.body, entry.size, type, position, size);
+    } else {
+        handle = m_objects.emplace(m_world.get(), type, position, size);
+        if (!m_objects.get(handle)->getBody()) {
+            m_objects.remove(handle);
+            return ObjectHandle();
+        }
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (pooled) {
+        m_poolStats.pooledSpawns++;
+        m_poolStats.pooledSeconds += elapsed;
+    } else {
+        m_poolStats.builtSpawns++;
+        m_poolStats.builtSeconds += elapsed;
+    }
+    return handle;
+}
+
+void PhysicsWorld::destroyObject(ObjectHandle handle) {
+    PhysicsObject* object = m_objects.get(handle);
+    if (!object) return;
+
+    if (object->hasReachedGoal()) {
+        m_goalCount--;
+    }
+    recycleBody(*object);
+    m_objects.remove(handle);
 }
 
 void PhysicsWorld::clearObjects() {
+    for (auto& obj : m_objects) {
+        recycleBody(obj);
+    }
     m_objects.clear();
+    m_goalCount = 0;
 }
 
-GravityField* PhysicsWorld::createGravityField(const Vec2& position, const Vec2& direction, float strength, float radius) {
-    auto field = std::make_unique<GravityField>(position, direction, strength, radius);
-    GravityField* ptr = field.get();
-    m_gravityFields.push_back(std::move(field));
-    return ptr;
-}
+void PhysicsWorld::prewarmBodies(ObjectType type, float size, int count) {
+    if (!m_world) return;
 
-void PhysicsWorld::removeGravityField(GravityField* field) {
-    for (auto it = m_gravityFields.begin(); it != m_gravityFields.end(); ++it) {
-        if (it->get() == field) {
-            m_gravityFields.erase(it);
-            return;
+    auto& pool = m_bodyPool[static_cast<size_t>(type)];
+    for (int i = 0; i < count; ++i) {
+        b2Body* body = PhysicsObject::buildBody(m_world.get(), type, Vec2(0, 0), size, false);
+        if (body) {
+            pool.push_back(PooledBody{body, size});
         }
     }
 }
 
-void PhysicsWorld::applyGravityFromStrokes(const std::vector<GravityStroke>& strokes) {
-    // Clear temporary gravity fields
-    clearGravityFields();
+void PhysicsWorld::recycleBody(PhysicsObject& object) {
+    if (b2Body* body = object.releaseBody()) {
+        m_bodyPool[static_cast<size_t>(object.getType())].push_back(PooledBody{body, object.getSize()});
+    }
+}
+
+FieldHandle PhysicsWorld::createGravityField(const Vec2& position, const Vec2& direction, float strength, float radius) {
+    FieldHandle handle = m_gravityFields.emplace(position, direction, strength, radius);
+    m_lodRefresh = true;
+    if (m_fieldTree) {
+        // The tree keeps the slot index, which doesn't change when fields are compacted
+        GravityField& field = *m_gravityFields.get(handle);
+        void* userData = reinterpret_cast<void*>(static_cast<uintptr_t>(handle.index));
+        field.setProxyId(m_fieldTree->CreateProxy(computeFieldAABB(field), userData));
+    }
+    return handle;
+}
 
-    // Create gravity fields from active strokes
+void PhysicsWorld::removeGravityField(FieldHandle handle) {
+    GravityField* field = m_gravityFields.get(handle);
+    if (!field) return;
+
+    destroyFieldProxy(*field);
+    m_gravityFields.remove(handle);
+}
+
+void PhysicsWorld::moveGravityField(FieldHandle handle, const Vec2& position) {
+    GravityField* field = m_gravityFields.get(handle);
+    if (!field) return;
+
+    b2Vec2 displacement = toMeters(position - field->getPosition());
+    field->setPosition(position);
+    m_lodRefresh = true;
+    if (field->getProxyId() >= 0) {
+        m_fieldTree->MoveProxy(field->getProxyId(), computeFieldAABB(*field), displacement);
+    }
+}
+
+void PhysicsWorld::refreshGravityField(FieldHandle handle) {
+    if (GravityField* field = m_gravityFields.get(handle)) {
+        refreshFieldProxy(*field);
+    }
+}
+
+void PhysicsWorld::refreshFieldProxy(GravityField& field) {
+    m_lodRefresh = true;
+    if (field.getProxyId() < 0) return;
+    m_fieldTree->MoveProxy(field.getProxyId(), computeFieldAABB(field), b2Vec2(0.0f, 0.0f));
+}
+
+void PhysicsWorld::setGravityMode(GravityMode mode) {
+    m_gravityMode = mode;
+    if (mode == GravityMode::Paint) {
+        m_paintGrid.resize(m_worldSize.x, m_worldSize.y, PAINT_GRID_CELL_SIZE);
+    }
+}
+
+FieldHandle PhysicsWorld::bindStrokeField(GravityStroke& stroke) {
+    if (m_gravityFields.contains(stroke.field) || stroke.points.size() < 2) return stroke.field;
+
+    // Painted strokes live in the grid and need no field of their own
+    if (m_gravityMode == GravityMode::Paint) {
+        m_paintGrid.splatStroke(stroke, GRAVITY_STROKE_RADIUS);
+        m_lodRefresh = true;
+        return FieldHandle();
+    }
+
+    // Use stroke midpoint as position
+    Vec2 midpoint = stroke.points[stroke.points.size() / 2];
+
+    stroke.field = createGravityField(
+        midpoint,
+        stroke.direction,
+        stroke.strength * stroke.getAlpha(),
+        GRAVITY_STROKE_RADIUS
+    );
+    GravityField* field = m_gravityFields.get(stroke.field);
+    field->setPath(stroke.points);  // Act along the whole swipe
+    field->setMaxLifetime(0); // Managed by the stroke
+    field->setColor(stroke.color);
+    field->setActive(stroke.isActive);
+    refreshFieldProxy(*field);  // The path widens the AABB
+    return stroke.field;
+}
+
+void PhysicsWorld::releaseStrokeField(GravityStroke& stroke) {
+    removeGravityField(stroke.field);
+    stroke.field = FieldHandle();
+}
+
+void PhysicsWorld::applyGravityFromStrokes(const std::vector<GravityStroke>& strokes) {
+    // Bound fields are updated in place; nothing is allocated per frame.
+    // A stale handle (the field was cleared under the stroke) is skipped.
     for (const auto& stroke : strokes) {
-        if (stroke.isActive && stroke.points.size() >= 2) {
-            // Use stroke midpoint as position
-            Vec2 midpoint = stroke.points[stroke.points.size() / 2];
-            float alpha = stroke.getAlpha();
-            
-            auto field = createGravityField(
-                midpoint,
-                stroke.direction,
-                stroke.strength * alpha,
-                GRAVITY_STROKE_RADIUS
-            );
-            field->setMaxLifetime(0); // Managed externally
-            field->setColor(stroke.color);
-        }
+        GravityField* field = m_gravityFields.get(stroke.field);
+        if (!field) continue;
+        field->setStrength(stroke.strength * stroke.getAlpha());
+        field->setActive(stroke.isActive);
     }
 }
 
 void PhysicsWorld::clearGravityFields() {
+    for (auto& field : m_gravityFields) {
+        destroyFieldProxy(field);
+    }
     m_gravityFields.clear();
 }
 
-DeformableSurface* PhysicsWorld::createDeformableSurface(const Vec2& position, float width, float height) {
-    auto surface = std::make_unique<DeformableSurface>(position, width, height);
-    surface->attachToWorld(m_world.get());
-    DeformableSurface* ptr = surface.get();
-    m_deformableSurfaces.push_back(std::move(surface));
+GravityZone* PhysicsWorld::createGravityZone(const Vec2& position, const Vec2& size, ZoneType type,
+                                             const Vec2& direction, float strength) {
+    auto zone = std::make_unique<GravityZone>(position, size.x, size.y, type);
+    if (direction.lengthSquared() > 0.0001f) {
+        zone->setDirection(direction);
+    }
+    zone->setStrength(zone->getStrength() * strength);  // Level data scales the base zone strength
+
+    GravityZone* ptr = zone.get();
+    m_gravityZones.push_back(std::move(zone));
     return ptr;
 }
 
-void PhysicsWorld::removeDeformableSurface(DeformableSurface* surface) {
-    for (auto it = m_deformableSurfaces.begin(); it != m_deformableSurfaces.end(); ++it) {
-        if (it->get() == surface) {
-            (*it)->detachFromWorld();
-            m_deformableSurfaces.erase(it);
-            return;
+void PhysicsWorld::bakeGravityZones() {
+    m_dragZones.clear();
+    if (m_gravityZones.empty()) {
+        m_zoneGrid.clear();
+        return;
+    }
+
+    for (const auto& zone : m_gravityZones) {
+        if (zone->getZoneType() == ZoneType::Slow) {
+            m_dragZones.push_back(zone.get());
         }
     }
+
+    // Position-only part of GravityZone::calculateZoneForce, summed over all zones
+    m_zoneGrid.resize(m_worldSize.x, m_worldSize.y, ZONE_GRID_CELL_SIZE);
+    m_zoneGrid.bake([this](const Vec2& point) {
+        Vec2 force(0, 0);
+        for (const auto& zone : m_gravityZones) {
+            force += zone->calculateZoneForce(point, Vec2(0, 0));
+        }
+        return force;
+    });
+}
+
+void PhysicsWorld::clearGravityZones() {
+    m_gravityZones.clear();
+    m_dragZones.clear();
+    m_zoneGrid.clear();
+}
+
+SurfaceHandle PhysicsWorld::createDeformableSurface(const Vec2& position, float width, float height) {
+    SurfaceHandle handle = m_deformableSurfaces.emplace(position, width, height);
+    m_deformableSurfaces.get(handle)->attachToWorld(m_world.get());
+    return handle;
+}
+
+void PhysicsWorld::removeDeformableSurface(SurfaceHandle handle) {
+    DeformableSurface* surface = m_deformableSurfaces.get(handle);
+    if (!surface) return;
+
+    surface->detachFromWorld();
+    m_deformableSurfaces.remove(handle);
 }
 
 void PhysicsWorld::createBoundaries(float width, float height) {
     destroyBoundaries();
 
+    m_worldSize = Vec2(width, height);
+    if (m_gravityMode == GravityMode::Paint) {
+        m_paintGrid.resize(width, height, PAINT_GRID_CELL_SIZE);
+    }
+
     if (!m_world) return;
 
     float thickness = 20.0f;
@@ -332,59 +981,255 @@ void PhysicsWorld::destroyStaticBody(b2Body* body) {
     }
 }
 
-void PhysicsWorld::createGoalZone(const Vec2& position, const Vec2& size) {
-    m_goalZone = Rect(position.x - size.x / 2, position.y - size.y / 2, size.x, size.y);
-    m_hasGoalZone = true;
-}
+void PhysicsWorld::addStaticObstacle(const Vec2& position, const Vec2& size, float rotation, bool circle) {
+    if (!m_world) return;
 
-bool PhysicsWorld::isObjectInGoal(PhysicsObject* object) const {
-    if (!m_hasGoalZone || !object) return false;
-    return m_goalZone.contains(object->getPosition());
+    if (!m_obstacleBody) {
+        b2BodyDef bodyDef;
+        bodyDef.type = b2_staticBody;
+        m_obstacleBody = m_world->CreateBody(&bodyDef);
+    }
+
+    // The compound body sits at the origin, so world space is body space
+    addObstacleFixture(m_obstacleBody, toMeters(position), size, rotation, circle);
 }
 
-std::vector<PhysicsObject*> PhysicsWorld::getObjectsInGoal() {
-    std::vector<PhysicsObject*> result;
-    if (!m_hasGoalZone) return result;
+size_t PhysicsWorld::addMovingObstacle(const Vec2& position, const Vec2& size, float rotation, bool circle,
+                                       const Vec2& direction, float speed, float distance) {
+    if (!m_world) return m_movers.size();
 
-    for (auto& obj : m_objects) {
-        // Once in goal, stays counted (sticky)
-        if (obj->hasReachedGoal() || m_goalZone.contains(obj->getPosition())) {
-            if (!obj->hasReachedGoal()) {
-                obj->setReachedGoal(true);
-            }
-            result.push_back(obj.get());
+    b2BodyDef bodyDef;
+    bodyDef.type = b2_kinematicBody;
+    bodyDef.position = toMeters(position);
+    bodyDef.angle = rotation;
+
+    Mover mover;
+    mover.body = m_world->CreateBody(&bodyDef);
+    mover.origin = bodyDef.position;
+    mover.travel = b2Vec2(0.0f, 0.0f);
+    mover.period = 0.0f;
+    mover.pathStart = 0;
+    mover.pathLength = 0;
+    addObstacleFixture(mover.body, b2Vec2(0.0f, 0.0f), size, 0.0f, circle);
+
+    float length = direction.length();
+    if (length > 0.0f && speed > 0.0f && distance > 0.0f) {
+        mover.travel = toMeters(direction * (distance / length));
+        mover.period = 2.0f * distance / speed;
+    }
+
+    m_movers.push_back(mover);
+    rebuildMoverPaths();
+    syncMovers();
+    return m_movers.size() - 1;
+}
+
+void PhysicsWorld::clearObstacles() {
+    if (m_world) {
+        if (m_obstacleBody) {
+            m_world->DestroyBody(m_obstacleBody);
+        }
+        for (const auto& mover : m_movers) {
+            m_world->DestroyBody(mover.body);
         }
     }
-    return result;
+
+    m_obstacleBody = nullptr;
+    m_movers.clear();
+    m_moverPaths.clear();
 }
 
-PhysicsObject* PhysicsWorld::getObjectAtPoint(const Vec2& point) {
-    b2Vec2 p = toMeters(point);
-    
-    for (const auto& obj : m_objects) {
-        if (obj->getBody()) {
-            for (b2Fixture* f = obj->getBody()->GetFixtureList(); f; f = f->GetNext()) {
-                if (f->TestPoint(p)) {
-                    return obj.get();
-                }
-            }
+Vec2 PhysicsWorld::getMovingObstaclePosition(size_t index, float alpha) const {
+    if (index >= m_movers.size()) return Vec2();
+
+    // Kinematic velocity is constant over a tick, so stepping back along it
+    // gives the same interpolation objects get from their previous transform
+    const b2Body* body = m_movers[index].body;
+    b2Vec2 position = body->GetPosition() - ((1.0f - alpha) * m_timestep) * body->GetLinearVelocity();
+    return toPixels(position);
+}
+
+void PhysicsWorld::rebuildMoverPaths() {
+    m_moverPaths.clear();
+
+    for (auto& mover : m_movers) {
+        uint32_t length = 1;
+        if (mover.period > 0.0f) {
+            length = std::max(2u, static_cast<uint32_t>(std::lround(mover.period / m_timestep)));
+        }
+
+        mover.pathStart = static_cast<uint32_t>(m_moverPaths.size());
+        mover.pathLength = length;
+
+        // Triangle wave: out along travel for half the period, then back
+        for (uint32_t i = 0; i < length; ++i) {
+            float phase = static_cast<float>(i) / length;
+            float s = phase < 0.5f ? 2.0f * phase : 2.0f - 2.0f * phase;
+            m_moverPaths.push_back(mover.origin + s * mover.travel);
         }
     }
-    return nullptr;
 }
 
-std::vector<PhysicsObject*> PhysicsWorld::getObjectsInArea(const Rect& area) {
-    std::vector<PhysicsObject*> result;
+void PhysicsWorld::updateMovers() {
+    // Drive each mover by velocity toward the next tick's path point rather
+    // than teleporting it, so it pushes dynamic bodies instead of tunnelling
+    // into them. Any drift is corrected the following tick.
+    float invStep = 1.0f / m_timestep;
+    for (const auto& mover : m_movers) {
+        const b2Vec2& target = m_moverPaths[mover.pathStart + (m_tick + 1) % mover.pathLength];
+        mover.body->SetLinearVelocity(invStep * (target - mover.body->GetPosition()));
+    }
+}
 
-    for (const auto& obj : m_objects) {
-        Vec2 pos = obj->getPosition();
-        if (area.contains(pos)) {
-            result.push_back(obj.get());
+void PhysicsWorld::syncMovers() {
+    // Place movers exactly where the path has them at the current tick
+    for (const auto& mover : m_movers) {
+        const b2Vec2& position = m_moverPaths[mover.pathStart + m_tick % mover.pathLength];
+        mover.body->SetTransform(position, mover.body->GetAngle());
+        mover.body->SetLinearVelocity(b2Vec2(0.0f, 0.0f));
+    }
+}
+
+void PhysicsWorld::createGoalZone(const Vec2& position, const Vec2& size) {
+    if (!m_world) return;
+
+    b2BodyDef bodyDef;
+    bodyDef.type = b2_staticBody;
+    bodyDef.position = toMeters(position);
+    b2Body* body = m_world->CreateBody(&bodyDef);
+
+    b2PolygonShape box;
+    box.SetAsBox(size.x / 2 / PHYSICS_SCALE, size.y / 2 / PHYSICS_SCALE);
+
+    b2FixtureDef fixtureDef;
+    fixtureDef.shape = &box;
+    fixtureDef.isSensor = true;
+    fixtureDef.userData.pointer = GOAL_SENSOR_TAG;
+    body->CreateFixture(&fixtureDef);
+
+    m_goalBodies.push_back(body);
+    m_goalRects.push_back(Rect(position.x - size.x / 2, position.y - size.y / 2, size.x, size.y));
+}
+
+void PhysicsWorld::clearGoalZones() {
+    // Destroying a sensor ends its contacts, which exits the objects inside
+    for (auto* body : m_goalBodies) {
+        if (m_world) {
+            m_world->DestroyBody(body);
         }
     }
+    m_goalBodies.clear();
+    m_goalRects.clear();
+}
+
+bool PhysicsWorld::isInsideGoal(const Vec2& position) const {
+    for (const Rect& goal : m_goalRects) {
+        if (goal.contains(position)) return true;
+    }
+    return false;
+}
+
+bool PhysicsWorld::isObjectInGoal(const PhysicsObject* object) const {
+    return object && object->isTouchingGoal() && isInsideGoal(object->getPosition());
+}
+
+void PhysicsWorld::onGoalEnter(PhysicsObject* object) {
+    // The sensor begins touching at the object's edge; it scores only with
+    // its centre inside, here or in a later updateGoalObjects
+    object->enterGoal();
+    if (isInsideGoal(object->getPosition()) && object->reachGoal()) {
+        m_goalCount++;
+    }
+}
+
+void PhysicsWorld::onGoalExit(PhysicsObject* object) {
+    object->exitGoal();
+}
+
+PhysicsObject* PhysicsWorld::getObjectAtPoint(const Vec2& point) {
+    if (!m_world) return nullptr;
+
+    PointQuery query;
+    query.point = toMeters(point);
+
+    b2AABB aabb;
+    aabb.lowerBound = query.point;
+    aabb.upperBound = query.point;
+    m_world->QueryAABB(&query, aabb);
+    return query.hit;
+}
+
+void PhysicsWorld::getObjectsAtPoints(const Vec2* points, size_t count, PhysicsObject** results) {
+    std::fill(results, results + count, nullptr);
+    if (!m_world || count == 0) return;
+
+    m_queryOrder.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        m_queryOrder[i] = static_cast<uint32_t>(i);
+    }
+    std::sort(m_queryOrder.begin(), m_queryOrder.end(), [points](uint32_t a, uint32_t b) {
+        return points[a].x < points[b].x || (points[a].x == points[b].x && a < b);
+    });
+
+    m_queryPoints.resize(count);
+    b2AABB aabb;
+    aabb.lowerBound = toMeters(points[m_queryOrder[0]]);
+    aabb.upperBound = aabb.lowerBound;
+    for (size_t i = 0; i < count; ++i) {
+        m_queryPoints[i] = toMeters(points[m_queryOrder[i]]);
+        aabb.lowerBound = b2Min(aabb.lowerBound, m_queryPoints[i]);
+        aabb.upperBound = b2Max(aabb.upperBound, m_queryPoints[i]);
+    }
+
+    PointBatchQuery query;
+    query.points = m_queryPoints.data();
+    query.order = m_queryOrder.data();
+    query.count = count;
+    query.remaining = count;
+    query.results = results;
+    m_world->QueryAABB(&query, aabb);
+}
+
+size_t PhysicsWorld::getObjectsInArea(const Rect& area, PhysicsObject** results, size_t capacity) {
+    if (!m_world) return 0;
+
+    AreaQuery query;
+    query.area = area;
+    query.results = results;
+    query.capacity = capacity;
+
+    b2AABB aabb;
+    aabb.lowerBound = toMeters(Vec2(area.x, area.y));
+    aabb.upperBound = toMeters(Vec2(area.x + area.w, area.y + area.h));
+    m_world->QueryAABB(&query, aabb);
+    return query.count;
+}
+
+std::vector<PhysicsObject*> PhysicsWorld::getObjectsInArea(const Rect& area) {
+    std::vector<PhysicsObject*> result(m_objects.size());
+    size_t count = getObjectsInArea(area, result.data(), result.size());
+    result.resize(std::min(count, result.size()));
     return result;
 }
 
+bool PhysicsWorld::rayCast(const Vec2& from, const Vec2& to, RayHit& hit) {
+    hit = RayHit();
+
+    // Box2D asserts on zero-length rays
+    if (!m_world || (to - from).lengthSquared() <= 0.0f) return false;
+
+    RayQuery query;
+    m_world->RayCast(&query, toMeters(from), toMeters(to));
+    if (!query.fixture) return false;
+
+    hit.hit = true;
+    hit.object = objectFromFixture(query.fixture);
+    hit.point = toPixels(query.point);
+    hit.normal = Vec2(query.normal.x, query.normal.y);
+    hit.fraction = query.fraction;
+    return true;
+}
+
 void PhysicsWorld::setGlobalGravity(const Vec2& gravity) {
     m_globalGravity = gravity;
     if (m_world) {
@@ -392,10 +1237,34 @@ void PhysicsWorld::setGlobalGravity(const Vec2& gravity) {
     }
 }
 
-void PhysicsWorld::setCollisionCallback(CollisionCallback callback) {
-    if (m_contactListener) {
-        m_contactListener->setCollisionCallback(callback);
+uint64_t PhysicsWorld::computeStateHash() const {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    };
+
+    // Ids are process-wide, so objects are keyed by their order instead
+    for (const auto& obj : m_objects) {
+        int type = static_cast<int>(obj.getType());
+        bool active = obj.isActive();
+        Vec2 position = obj.getPosition();
+        Vec2 velocity = obj.getVelocity();
+        float angle = obj.getAngle();
+        float energy = obj.getEnergy();
+        mix(&type, sizeof(type));
+        mix(&active, sizeof(active));
+        mix(&position.x, sizeof(float));
+        mix(&position.y, sizeof(float));
+        mix(&velocity.x, sizeof(float));
+        mix(&velocity.y, sizeof(float));
+        mix(&angle, sizeof(angle));
+        mix(&energy, sizeof(energy));
     }
+    return hash;
 }
 
 Vec2 PhysicsWorld::toPixels(const b2Vec2& meters) {
@@ -407,37 +1276,197 @@ b2Vec2 PhysicsWorld::toMeters(const Vec2& pixels) {
 }
 
 void PhysicsWorld::applyGravityFields() {
-    for (const auto& obj : m_objects) {
-        if (!obj->isActive() || !obj->getBody()) continue;
+    bool painted = m_gravityMode == GravityMode::Paint && !m_paintGrid.isEmpty();
+    bool zoned = !m_zoneGrid.isEmpty() || !m_dragZones.empty();
+    if (m_gravityFields.empty() && !painted && !zoned) return;
+
+    // Objects far off-screen or asleep in Box2D are idle: they reuse their
+    // last pull and are re-evaluated every PHYSICS_LOD_INTERVAL ticks,
+    // staggered by index. Any field change re-evaluates everyone. Awake
+    // on-screen objects are evaluated every tick, even with no pull, so
+    // one falling into a field feels it on the tick it arrives.
+    Rect lodBounds(-PHYSICS_LOD_MARGIN, -PHYSICS_LOD_MARGIN,
+                   m_worldSize.x + 2 * PHYSICS_LOD_MARGIN, m_worldSize.y + 2 * PHYSICS_LOD_MARGIN);
+
+    // Gather active object positions into SoA form
+    m_batchObjects.clear();
+    m_batchPosX.clear();
+    m_batchPosY.clear();
+
+    for (size_t i = 0; i < m_objects.size(); ++i) {
+        PhysicsObject& obj = m_objects[i];
+        if (!obj.isActive() || !obj.getBody() || obj.isFrozen()) continue;
+
+        Vec2 pos = obj.getPosition();
+        bool idle = !obj.getBody()->IsAwake() || !lodBounds.contains(pos);
+
+        if (m_lodEnabled && !m_lodRefresh && idle && obj.isReducedRate() && (m_tick + i) % PHYSICS_LOD_INTERVAL != 0) {
+            applyFieldForce(obj, obj.getFieldForce());
+            m_stepStats.reducedRateSkips++;
+            continue;
+        }
 
-        Vec2 objPos = obj->getPosition();
-        Vec2 totalForce(0, 0);
+        m_batchObjects.push_back(static_cast<uint32_t>(i));
+        m_batchPosX.push_back(pos.x);
+        m_batchPosY.push_back(pos.y);
+    }
+    m_lodRefresh = false;
+
+    size_t count = m_batchObjects.size();
+    m_batchForceX.resize(count);
+    m_batchForceY.resize(count);
+    computeGravityForces(m_batchPosX.data(), m_batchPosY.data(),
+                         m_batchForceX.data(), m_batchForceY.data(), count);
+
+    for (size_t i = 0; i < count; ++i) {
+        Vec2 totalForce(m_batchForceX[i], m_batchForceY[i]);
+        Vec2 pos(m_batchPosX[i], m_batchPosY[i]);
+        PhysicsObject& obj = m_objects[m_batchObjects[i]];
+        bool dragged = false;
+
+        if (painted) {
+            totalForce += m_paintGrid.sample(pos);
+        }
 
-        for (const auto& field : m_gravityFields) {
-            if (field->isActive() && field->isPointInRange(objPos)) {
-                totalForce += field->calculateForce(objPos);
+        if (zoned) {
+            totalForce += m_zoneGrid.sample(pos);
+
+            for (const GravityZone* zone : m_dragZones) {
+                if (zone->isPointInZone(pos)) {
+                    b2Vec2 vel = obj.getBody()->GetLinearVelocity();
+                    totalForce -= Vec2(vel.x, vel.y) * 0.5f;
+                    dragged = true;
+                }
             }
         }
 
-        if (totalForce.lengthSquared() > 0.01f) {
-            obj->applyForce(totalForce * obj->getMass());
+        // Drag depends on velocity, so a cached value would go stale. Whether
+        // the object is still idle is checked again before the cache is used.
+        bool idle = !dragged && (!obj.getBody()->IsAwake() || !lodBounds.contains(pos));
+        obj.setFieldForce(totalForce, idle);
+        applyFieldForce(obj, totalForce);
+    }
+}
+
+void PhysicsWorld::applyFieldForce(PhysicsObject& object, const Vec2& acceleration) {
+    float strengthSquared = acceleration.lengthSquared();
+    if (strengthSquared <= 0.01f) return;
+
+    // A sleeping body is only woken by a pull strong enough to move it
+    if (m_lodEnabled && !object.getBody()->IsAwake() &&
+        strengthSquared < PHYSICS_WAKE_ACCELERATION * PHYSICS_WAKE_ACCELERATION) {
+        m_stepStats.sleepingSkips++;
+        return;
+    }
+    object.applyForce(acceleration * object.getMass());
+}
+
+void PhysicsWorld::updateGoalObjects() {
+    for (auto& obj : m_objects) {
+        // A touching object may have moved its centre in since contact began
+        if (obj.isTouchingGoal() && !obj.hasReachedGoal() && isInsideGoal(obj.getPosition()) &&
+            obj.reachGoal()) {
+            m_goalCount++;
+        }
+
+        // Box2D only puts a body to sleep once its whole island has settled
+        if (m_lodEnabled && obj.hasReachedGoal() && obj.isActive() && !obj.isFrozen() &&
+            obj.getBody() && !obj.getBody()->IsAwake()) {
+            obj.freeze();
+            m_stepStats.frozenObjects++;
+        }
+    }
+}
+
+void PhysicsWorld::computeGravityForces(const float* posX, const float* posY,
+                                        float* forceX, float* forceY, size_t count) {
+    std::fill(forceX, forceX + count, 0.0f);
+    std::fill(forceY, forceY + count, 0.0f);
+
+    if (m_gravityFields.empty() || count == 0 || !m_fieldTree) return;
+
+    // Broadphase: pair each position with the fields whose AABB overlaps it
+    m_fieldPairs.clear();
+    FieldQuery query{&m_fieldPairs, 0};
+
+    for (size_t i = 0; i < count; ++i) {
+        b2AABB aabb;
+        aabb.lowerBound = toMeters(Vec2(posX[i], posY[i]));
+        aabb.upperBound = aabb.lowerBound;
+        query.index = static_cast<int32>(i);
+        m_fieldTree->Query(&query, aabb);
+    }
+
+    // Group by field so each field runs its specialized kernel once
+    std::sort(m_fieldPairs.begin(), m_fieldPairs.end());
+
+    size_t begin = 0;
+    while (begin < m_fieldPairs.size()) {
+        int32 proxyId = m_fieldPairs[begin].first;
+        size_t end = begin;
+        while (end < m_fieldPairs.size() && m_fieldPairs[end].first == proxyId) {
+            ++end;
+        }
+
+        size_t n = end - begin;
+        m_gatherPosX.resize(n);
+        m_gatherPosY.resize(n);
+        m_gatherForceX.assign(n, 0.0f);
+        m_gatherForceY.assign(n, 0.0f);
+
+        for (size_t k = 0; k < n; ++k) {
+            int32 index = m_fieldPairs[begin + k].second;
+            m_gatherPosX[k] = posX[index];
+            m_gatherPosY[k] = posY[index];
         }
+
+        auto slot = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(m_fieldTree->GetUserData(proxyId)));
+        accumulateFieldForces(m_gravityFields.atSlot(slot), m_gatherPosX.data(), m_gatherPosY.data(),
+                              m_gatherForceX.data(), m_gatherForceY.data(), n);
+
+        for (size_t k = 0; k < n; ++k) {
+            int32 index = m_fieldPairs[begin + k].second;
+            forceX[index] += m_gatherForceX[k];
+            forceY[index] += m_gatherForceY[k];
+        }
+
+        begin = end;
+    }
+}
+
+b2AABB PhysicsWorld::computeFieldAABB(const GravityField& field) const {
+    float radius = field.getRadius();
+    Rect bounds(field.getPosition().x, field.getPosition().y, 0.0f, 0.0f);
+    if (field.hasPath()) {
+        bounds = field.getPath().getBounds();
+    }
+
+    b2AABB aabb;
+    aabb.lowerBound = toMeters(Vec2(bounds.x - radius, bounds.y - radius));
+    aabb.upperBound = toMeters(Vec2(bounds.x + bounds.w + radius, bounds.y + bounds.h + radius));
+    return aabb;
+}
+
+void PhysicsWorld::destroyFieldProxy(GravityField& field) {
+    if (field.getProxyId() >= 0 && m_fieldTree) {
+        m_fieldTree->DestroyProxy(field.getProxyId());
+        field.setProxyId(-1);
     }
 }
 
 void PhysicsWorld::updateDeformableSurfaces(float deltaTime) {
     for (auto& surface : m_deformableSurfaces) {
-        surface->update(deltaTime);
+        surface.update(deltaTime);
 
-        // Check for collisions with physics objects
+        // Check for collisions with physics objects. isPointNear rejects
+        // objects outside the surface bounds before touching any node.
         for (const auto& obj : m_objects) {
-            if (obj->isActive()) {
-                Vec2 pos = obj->getPosition();
-                Vec2 vel = obj->getVelocity();
-                float impact = vel.length();
+            if (obj.isActive()) {
+                Vec2 pos = obj.getPosition();
+                float impact = obj.getVelocity().length();
 
-                if (surface->isPointNear(pos) && impact > 5.0f) {
-                    surface->applyImpact(pos, impact);
+                if (impact > 5.0f && surface.isPointNear(pos)) {
+                    surface.applyImpact(pos, impact);
                 }
             }
         }
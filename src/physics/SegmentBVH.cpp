@@ -0,0 +1,136 @@
+#include "GravityPaint/physics/SegmentBVH.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace GravityPaint {
+
+void SegmentBVH::build(const std::vector<Vec2>& points) {
+    clear();
+    if (points.size() < 2) return;
+
+    m_points = points;
+    m_segments.reserve(points.size() - 1);
+    for (size_t i = 0; i + 1 < points.size(); ++i) {
+        m_segments.push_back(static_cast<int>(i));
+    }
+
+    // A binary tree over n segments with leaves of LEAF_SIZE never needs more than 2n nodes
+    m_nodes.reserve(m_segments.size() * 2);
+    buildNode(0, static_cast<int>(m_segments.size()));
+}
+
+void SegmentBVH::clear() {
+    m_points.clear();
+    m_segments.clear();
+    m_nodes.clear();
+}
+
+Rect SegmentBVH::getBounds() const {
+    if (m_nodes.empty()) return Rect();
+    const Node& root = m_nodes[0];
+    return Rect(root.minX, root.minY, root.maxX - root.minX, root.maxY - root.minY);
+}
+
+int SegmentBVH::buildNode(int first, int count) {
+    int index = static_cast<int>(m_nodes.size());
+    m_nodes.emplace_back();
+
+    Node node;
+    node.minX = node.minY = std::numeric_limits<float>::max();
+    node.maxX = node.maxY = std::numeric_limits<float>::lowest();
+
+    for (int i = first; i < first + count; ++i) {
+        const Vec2& a = m_points[m_segments[i]];
+        const Vec2& b = m_points[m_segments[i] + 1];
+        node.minX = std::min(node.minX, std::min(a.x, b.x));
+        node.minY = std::min(node.minY, std::min(a.y, b.y));
+        node.maxX = std::max(node.maxX, std::max(a.x, b.x));
+        node.maxY = std::max(node.maxY, std::max(a.y, b.y));
+    }
+
+    if (count <= LEAF_SIZE) {
+        node.first = first;
+        node.count = count;
+        m_nodes[index] = node;
+        return index;
+    }
+
+    // Median split on the longer axis by segment midpoint
+    bool splitX = (node.maxX - node.minX) >= (node.maxY - node.minY);
+    auto midpoint = [this, splitX](int segment) {
+        const Vec2& a = m_points[segment];
+        const Vec2& b = m_points[segment + 1];
+        return splitX ? a.x + b.x : a.y + b.y;
+    };
+
+    int half = count / 2;
+    std::nth_element(m_segments.begin() + first,
+                     m_segments.begin() + first + half,
+                     m_segments.begin() + first + count,
+                     [&midpoint](int a, int b) { return midpoint(a) < midpoint(b); });
+
+    node.left = buildNode(first, half);
+    node.right = buildNode(first + half, count - half);
+    m_nodes[index] = node;
+    return index;
+}
+
+float SegmentBVH::distanceSqToBox(const Node& node, const Vec2& point) {
+    float dx = std::max(0.0f, std::max(node.minX - point.x, point.x - node.maxX));
+    float dy = std::max(0.0f, std::max(node.minY - point.y, point.y - node.maxY));
+    return dx * dx + dy * dy;
+}
+
+bool SegmentBVH::findClosest(const Vec2& point, float maxDistance, Vec2& closest, float& distance) const {
+    if (m_nodes.empty()) return false;
+
+    float bestSq = maxDistance * maxDistance;
+    bool found = false;
+
+    int stack[MAX_STACK];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const Node& node = m_nodes[stack[--top]];
+        if (distanceSqToBox(node, point) > bestSq) continue;
+
+        if (node.count > 0) {
+            for (int i = node.first; i < node.first + node.count; ++i) {
+                const Vec2& a = m_points[m_segments[i]];
+                const Vec2& b = m_points[m_segments[i] + 1];
+
+                Vec2 ab = b - a;
+                float lengthSq = ab.lengthSquared();
+                float t = lengthSq > 0.0f ? std::clamp((point - a).dot(ab) / lengthSq, 0.0f, 1.0f) : 0.0f;
+                Vec2 candidate = a + ab * t;
+
+                float distSq = (point - candidate).lengthSquared();
+                if (distSq <= bestSq) {
+                    bestSq = distSq;
+                    closest = candidate;
+                    found = true;
+                }
+            }
+        } else if (top + 2 <= MAX_STACK) {
+            // Visit the nearer child first so the far one is more likely to be pruned
+            const Node& left = m_nodes[node.left];
+            const Node& right = m_nodes[node.right];
+            if (distanceSqToBox(left, point) < distanceSqToBox(right, point)) {
+                stack[top++] = node.right;
+                stack[top++] = node.left;
+            } else {
+                stack[top++] = node.left;
+                stack[top++] = node.right;
+            }
+        }
+    }
+
+    if (found) {
+        distance = std::sqrt(bestSq);
+    }
+    return found;
+}
+
+} // namespace GravityPaint
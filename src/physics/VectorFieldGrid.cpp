@@ -0,0 +1,165 @@
+#include "GravityPaint/physics/VectorFieldGrid.h"
+#include "GravityPaint/physics/SegmentBVH.h"
+#include "GravityPaint/physics/SimdFloat4.h"
+#include "GravityPaint/Constants.h"
+#include <algorithm>
+#include <cmath>
+
+namespace GravityPaint {
+
+void VectorFieldGrid::resize(float width, float height, float cellSize) {
+    m_cellSize = std::max(cellSize, 1.0f);
+    m_invCellSize = 1.0f / m_cellSize;
+    m_columns = std::max(1, static_cast<int>(std::ceil(width * m_invCellSize)));
+    m_rows = std::max(1, static_cast<int>(std::ceil(height * m_invCellSize)));
+
+    // One border cell on each side keeps the stencil and sampler branch-free
+    m_stride = (m_columns + 2 + 3) & ~3;
+    size_t size = static_cast<size_t>(m_stride) * (m_rows + 2);
+
+    m_forceX.assign(size, 0.0f);
+    m_forceY.assign(size, 0.0f);
+    m_scratchX.assign(size, 0.0f);
+    m_scratchY.assign(size, 0.0f);
+    m_empty = true;
+}
+
+void VectorFieldGrid::clear() {
+    std::fill(m_forceX.begin(), m_forceX.end(), 0.0f);
+    std::fill(m_forceY.begin(), m_forceY.end(), 0.0f);
+    m_empty = true;
+}
+
+void VectorFieldGrid::splatStroke(const GravityStroke& stroke, float radius) {
+    if (m_forceX.empty() || stroke.points.size() < 2 || radius <= 0.0f) return;
+
+    SegmentBVH path;
+    path.build(stroke.points);
+    Rect bounds = path.getBounds();
+
+    int minColumn = std::max(0, static_cast<int>((bounds.x - radius) * m_invCellSize));
+    int maxColumn = std::min(m_columns - 1, static_cast<int>((bounds.x + bounds.w + radius) * m_invCellSize));
+    int minRow = std::max(0, static_cast<int>((bounds.y - radius) * m_invCellSize));
+    int maxRow = std::min(m_rows - 1, static_cast<int>((bounds.y + bounds.h + radius) * m_invCellSize));
+
+    Vec2 push = stroke.direction * stroke.strength;
+
+    for (int row = minRow; row <= maxRow; ++row) {
+        for (int column = minColumn; column <= maxColumn; ++column) {
+            Vec2 center((column + 0.5f) * m_cellSize, (row + 0.5f) * m_cellSize);
+
+            Vec2 closest;
+            float distance;
+            if (!path.findClosest(center, radius, closest, distance)) continue;
+
+            float falloff = 1.0f - distance / radius;
+            falloff = falloff * falloff;
+
+            int i = index(column, row);
+            m_forceX[i] += push.x * falloff;
+            m_forceY[i] += push.y * falloff;
+            m_empty = false;
+        }
+    }
+}
+
+void VectorFieldGrid::bake(const std::function<Vec2(const Vec2&)>& force) {
+    clear();
+    for (int row = 0; row < m_rows; ++row) {
+        for (int column = 0; column < m_columns; ++column) {
+            Vec2 value = force(Vec2((column + 0.5f) * m_cellSize, (row + 0.5f) * m_cellSize));
+            int i = index(column, row);
+            m_forceX[i] = value.x;
+            m_forceY[i] = value.y;
+            if (value.x != 0.0f || value.y != 0.0f) {
+                m_empty = false;
+            }
+        }
+    }
+}
+
+void VectorFieldGrid::decay(float deltaTime, float rate) {
+    if (m_empty) return;
+
+    const Float4 factor = Float4::splat(std::exp(-rate * deltaTime));
+    size_t size = m_forceX.size();  // Always a multiple of 4
+    Float4 peak = Float4::zero();
+
+    for (size_t i = 0; i < size; i += 4) {
+        Float4 x = Float4::load(&m_forceX[i]) * factor;
+        Float4 y = Float4::load(&m_forceY[i]) * factor;
+        x.store(&m_forceX[i]);
+        y.store(&m_forceY[i]);
+        peak = Float4::max(peak, x * x + y * y);
+    }
+
+    // Once nothing is left worth sampling, zero the remainder so sample()
+    // and the force stage can take their empty-grid early outs again
+    float lanes[4];
+    peak.store(lanes);
+    float peakSq = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+    if (peakSq < PAINT_FIELD_EPSILON * PAINT_FIELD_EPSILON) {
+        clear();
+    }
+}
+
+void VectorFieldGrid::diffuse(float deltaTime, float rate) {
+    if (m_empty || rate <= 0.0f) return;
+
+    // Explicit 5-point Laplacian; k <= 0.2 keeps the step stable
+    float k = std::min(rate * deltaTime, 0.2f);
+    const Float4 kv = Float4::splat(k);
+    const Float4 centerWeight = Float4::splat(1.0f - 4.0f * k);
+
+    auto diffuseChannel = [&](const std::vector<float>& src, std::vector<float>& dst) {
+        for (int row = 0; row < m_rows; ++row) {
+            int column = 0;
+            for (; column + 4 <= m_columns; column += 4) {
+                const float* p = &src[index(column, row)];
+                Float4 neighbors = Float4::load(p - 1) + Float4::load(p + 1) +
+                                   Float4::load(p - m_stride) + Float4::load(p + m_stride);
+                (Float4::load(p) * centerWeight + neighbors * kv).store(&dst[index(column, row)]);
+            }
+            for (; column < m_columns; ++column) {
+                int i = index(column, row);
+                float neighbors = src[i - 1] + src[i + 1] + src[i - m_stride] + src[i + m_stride];
+                dst[i] = src[i] * (1.0f - 4.0f * k) + neighbors * k;
+            }
+        }
+    };
+
+    diffuseChannel(m_forceX, m_scratchX);
+    diffuseChannel(m_forceY, m_scratchY);
+    m_forceX.swap(m_scratchX);
+    m_forceY.swap(m_scratchY);
+}
+
+Vec2 VectorFieldGrid::sample(const Vec2& position) const {
+    if (m_empty) return Vec2(0, 0);
+
+    // Cell values live at cell centers; the zero border fades forces out at the edges
+    float gx = std::clamp(position.x * m_invCellSize - 0.5f, -1.0f, static_cast<float>(m_columns));
+    float gy = std::clamp(position.y * m_invCellSize - 0.5f, -1.0f, static_cast<float>(m_rows));
+
+    int x0 = std::min(static_cast<int>(std::floor(gx)), m_columns - 1);
+    int y0 = std::min(static_cast<int>(std::floor(gy)), m_rows - 1);
+    float tx = gx - x0;
+    float ty = gy - y0;
+
+    int i00 = index(x0, y0);
+    int i10 = i00 + 1;
+    int i01 = i00 + m_stride;
+    int i11 = i01 + 1;
+
+    float w00 = (1.0f - tx) * (1.0f - ty);
+    float w10 = tx * (1.0f - ty);
+    float w01 = (1.0f - tx) * ty;
+    float w11 = tx * ty;
+
+    return Vec2(
+        m_forceX[i00] * w00 + m_forceX[i10] * w10 + m_forceX[i01] * w01 + m_forceX[i11] * w11,
+        m_forceY[i00] * w00 + m_forceY[i10] * w10 + m_forceY[i01] * w01 + m_forceY[i11] * w11
+    );
+}
+
+} // namespace GravityPaint
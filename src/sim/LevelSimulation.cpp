@@ -0,0 +1,144 @@
+#include "GravityPaint/sim/LevelSimulation.h"
+#include "GravityPaint/sim/Replay.h"
+#include "GravityPaint/physics/PhysicsWorld.h"
+#include "GravityPaint/level/LevelManager.h"
+#include "GravityPaint/level/Level.h"
+
+namespace GravityPaint {
+
+LevelSimulation::LevelSimulation(PhysicsWorld* physics, LevelManager* levelManager)
+    : m_physics(physics)
+    , m_levelManager(levelManager)
+{
+    m_physics->setPreTickCallback([this](uint64_t tick, float timestep) { preTick(tick, timestep); });
+    m_physics->setPostTickCallback([this](uint64_t tick, float timestep) { postTick(tick, timestep); });
+    m_physics->setContactCallback([this](const std::vector<ContactEvent>& contacts) { onContacts(contacts); });
+    m_contacts.reserve(CONTACT_EVENT_CAPACITY);
+}
+
+LevelSimulation::~LevelSimulation() {
+    m_physics->setPreTickCallback(nullptr);
+    m_physics->setPostTickCallback(nullptr);
+    m_physics->setContactCallback(nullptr);
+}
+
+bool LevelSimulation::setupLevel(GravityMode mode, float paintDiffusion) {
+    m_pending.clear();
+    m_strokes.clear();
+    m_contacts.clear();
+
+    // A fresh Box2D world and field tree, so solver and broadphase order
+    // don't depend on what earlier levels allocated; replays rely on it.
+    // Pooled bodies belong to the old world and can't carry over, so the
+    // pool is refilled from this level's spawn list below.
+    m_physics->shutdown();
+    m_physics->initialize();
+    m_physics->reset();
+    m_physics->setGravityMode(mode);
+    m_physics->setPaintDiffusion(paintDiffusion);
+
+    if (!m_levelManager->getCurrentLevel()) {
+        m_levelManager->loadLevel(1);
+    }
+
+    m_levelManager->startLevel();
+
+    Level* level = m_levelManager->getCurrentLevel();
+    if (!level) {
+        return false;
+    }
+
+    m_physics->createBoundaries(level->getWidth(), level->getHeight());
+    for (const auto& goal : level->getGoalZones()) {
+        m_physics->createGoalZone(goal.center(), Vec2(goal.w, goal.h));
+    }
+
+    for (const auto& zone : level->getGravityZones()) {
+        m_physics->createGravityZone(zone.position, zone.size, zone.type, zone.direction, zone.strength);
+    }
+    m_physics->bakeGravityZones();
+
+    for (const auto& obstacle : level->getObstacles()) {
+        if (obstacle.isMoving) {
+            m_physics->addMovingObstacle(obstacle.position, obstacle.size, obstacle.rotation, obstacle.isCircle,
+                                         obstacle.moveDirection, obstacle.moveSpeed, obstacle.moveDistance);
+        } else if (obstacle.isDeformable) {
+            m_physics->createDeformableSurface(obstacle.position, obstacle.size.x, obstacle.size.y);
+        } else {
+            m_physics->addStaticObstacle(obstacle.position, obstacle.size, obstacle.rotation, obstacle.isCircle);
+        }
+    }
+
+    // Delayed spawns land mid-play, so their bodies are built now; the
+    // ones spawned at load build theirs directly
+    for (const auto& spawn : level->getSpawnPoints()) {
+        if (spawn.delay > 0) {
+            m_physics->prewarmBodies(spawn.objectType, spawn.size, 1);
+        }
+    }
+
+    m_levelManager->spawnObjects(m_physics);
+    return true;
+}
+
+void LevelSimulation::commitStroke(const GravityStroke& stroke) {
+    m_pending.push_back(stroke);
+    m_pending.back().field = FieldHandle();
+}
+
+void LevelSimulation::clearStrokes() {
+    m_pending.clear();
+    for (auto& stroke : m_strokes) {
+        m_physics->releaseStrokeField(stroke);
+    }
+    m_strokes.clear();
+}
+
+void LevelSimulation::update(float deltaTime) {
+    m_contacts.clear();
+    m_physics->update(deltaTime);
+}
+
+void LevelSimulation::preTick(uint64_t tick, float timestep) {
+    for (auto& stroke : m_pending) {
+        if (m_recorder) {
+            m_recorder->recordStroke(tick, stroke);
+        }
+        if (m_strokes.size() >= m_strokeLimit) {
+            m_physics->releaseStrokeField(m_strokes.front());
+            m_strokes.erase(m_strokes.begin());
+        }
+        m_strokes.push_back(std::move(stroke));
+        m_physics->bindStrokeField(m_strokes.back());
+    }
+    m_pending.clear();
+
+    for (auto it = m_strokes.begin(); it != m_strokes.end();) {
+        it->lifetime += timestep;
+        if (it->lifetime >= it->maxLifetime) {
+            m_physics->releaseStrokeField(*it);
+            it = m_strokes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    m_physics->applyGravityFromStrokes(m_strokes);
+}
+
+void LevelSimulation::postTick(uint64_t tick, float timestep) {
+    m_levelManager->updateSpawns(timestep, m_physics);
+    m_levelManager->updateLevel(timestep);
+    m_levelManager->updateObjectiveProgress(m_physics);
+
+    if (m_recorder) {
+        m_recorder->recordTick(tick, m_physics->computeStateHash());
+    }
+}
+
+void LevelSimulation::onContacts(const std::vector<ContactEvent>& contacts) {
+    m_levelManager->recordContacts(contacts);
+    m_contacts.insert(m_contacts.end(), contacts.begin(), contacts.end());
+}
+
+} // namespace GravityPaint
@@ -0,0 +1,233 @@
+#include "GravityPaint/sim/Replay.h"
+#include "GravityPaint/sim/LevelSimulation.h"
+#include "GravityPaint/physics/PhysicsWorld.h"
+#include "GravityPaint/level/LevelManager.h"
+#include "GravityPaint/level/Level.h"
+#include "GravityPaint/level/Objective.h"
+#include <chrono>
+#include <fstream>
+#include <type_traits>
+
+namespace GravityPaint {
+
+namespace {
+
+constexpr uint32_t REPLAY_MAGIC = 0x50525047;  // "GPRP"
+constexpr uint32_t REPLAY_VERSION = 1;
+
+template <typename T>
+void writeValue(std::ofstream& file, const T& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::ifstream& file, T& value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+// Reads an enum written as its underlying value, rejecting anything
+// outside [0, last]
+template <typename E>
+bool readEnum(std::ifstream& file, E& value, E last) {
+    using Raw = typename std::underlying_type<E>::type;
+    Raw raw = 0;
+    if (!readValue(file, raw) || raw < 0 || raw > static_cast<Raw>(last)) return false;
+    value = static_cast<E>(raw);
+    return true;
+}
+
+// Bytes between the read position and the end of a file of fileSize
+// bytes. Counts read from the file are checked against this before
+// anything is allocated for them, so a corrupt count can't ask for more
+// memory than the file could possibly fill.
+uint64_t remainingBytes(std::ifstream& file, std::streamoff fileSize) {
+    std::streamoff position = file.tellg();
+    if (position < 0 || position > fileSize) return 0;
+    return static_cast<uint64_t>(fileSize - position);
+}
+
+// A stroke's bytes apart from its points
+constexpr uint64_t STROKE_FIXED_BYTES =
+    sizeof(uint64_t) + sizeof(uint32_t) + sizeof(GravityStroke::direction) + sizeof(GravityStroke::strength) +
+    sizeof(GravityStroke::lifetime) + sizeof(GravityStroke::maxLifetime) + sizeof(GravityStroke::color) +
+    sizeof(GravityStroke::isActive);
+
+} // namespace
+
+bool Replay::save(const std::string& filepath) const {
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    writeValue(file, REPLAY_MAGIC);
+    writeValue(file, REPLAY_VERSION);
+    writeValue(file, levelId);
+    writeValue(file, difficulty);
+    writeValue(file, gravityMode);
+    writeValue(file, paintDiffusion);
+    writeValue(file, tickRate);
+    writeValue(file, strokeLimit);
+    writeValue(file, screenWidth);
+    writeValue(file, screenHeight);
+    writeValue(file, levelSeed);
+    writeValue(file, effectsSeed);
+
+    writeValue(file, static_cast<uint32_t>(strokes.size()));
+    for (const auto& entry : strokes) {
+        const GravityStroke& stroke = entry.stroke;
+        writeValue(file, entry.tick);
+        writeValue(file, static_cast<uint32_t>(stroke.points.size()));
+        file.write(reinterpret_cast<const char*>(stroke.points.data()),
+                   stroke.points.size() * sizeof(Vec2));
+        writeValue(file, stroke.direction);
+        writeValue(file, stroke.strength);
+        writeValue(file, stroke.lifetime);
+        writeValue(file, stroke.maxLifetime);
+        writeValue(file, stroke.color);
+        writeValue(file, stroke.isActive);
+    }
+
+    writeValue(file, static_cast<uint32_t>(tickHashes.size()));
+    file.write(reinterpret_cast<const char*>(tickHashes.data()),
+               tickHashes.size() * sizeof(uint64_t));
+
+    return static_cast<bool>(file);
+}
+
+bool Replay::load(const std::string& filepath) {
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+    std::streamoff fileSize = file.tellg();
+    file.seekg(0);
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    if (!readValue(file, magic) || magic != REPLAY_MAGIC) return false;
+    if (!readValue(file, version) || version != REPLAY_VERSION) return false;
+
+    if (!readValue(file, levelId) ||
+        !readEnum(file, difficulty, Difficulty::Hard) ||
+        !readEnum(file, gravityMode, GravityMode::Paint) ||
+        !readValue(file, paintDiffusion) ||
+        !readValue(file, tickRate) ||
+        !readValue(file, strokeLimit) ||
+        !readValue(file, screenWidth) ||
+        !readValue(file, screenHeight) ||
+        !readValue(file, levelSeed) ||
+        !readValue(file, effectsSeed)) {
+        return false;
+    }
+
+    uint32_t strokeCount = 0;
+    if (!readValue(file, strokeCount)) return false;
+    if (strokeCount > remainingBytes(file, fileSize) / STROKE_FIXED_BYTES) return false;
+    strokes.assign(strokeCount, ReplayStroke());
+    for (auto& entry : strokes) {
+        GravityStroke& stroke = entry.stroke;
+        uint32_t pointCount = 0;
+        readValue(file, entry.tick);
+        if (!readValue(file, pointCount)) return false;
+        if (pointCount > remainingBytes(file, fileSize) / sizeof(Vec2)) return false;
+        stroke.points.resize(pointCount);
+        file.read(reinterpret_cast<char*>(stroke.points.data()), pointCount * sizeof(Vec2));
+        readValue(file, stroke.direction);
+        readValue(file, stroke.strength);
+        readValue(file, stroke.lifetime);
+        readValue(file, stroke.maxLifetime);
+        readValue(file, stroke.color);
+        readValue(file, stroke.isActive);
+    }
+
+    uint32_t hashCount = 0;
+    if (!readValue(file, hashCount)) return false;
+    if (hashCount > remainingBytes(file, fileSize) / sizeof(uint64_t)) return false;
+    tickHashes.resize(hashCount);
+    file.read(reinterpret_cast<char*>(tickHashes.data()), hashCount * sizeof(uint64_t));
+
+    return static_cast<bool>(file);
+}
+
+void ReplayRecorder::begin(const Replay& header) {
+    m_replay = header;
+    m_replay.strokes.clear();
+    m_replay.tickHashes.clear();
+    m_recording = true;
+}
+
+void ReplayRecorder::recordStroke(uint64_t tick, const GravityStroke& stroke) {
+    if (!m_recording) return;
+
+    ReplayStroke entry;
+    entry.tick = tick;
+    entry.stroke = stroke;
+    entry.stroke.field = FieldHandle();
+    m_replay.strokes.push_back(std::move(entry));
+}
+
+void ReplayRecorder::recordTick(uint64_t tick, uint64_t stateHash) {
+    if (!m_recording) return;
+
+    // A world rewound to an earlier tick overwrites the hashes after it
+    if (tick < m_replay.tickHashes.size()) {
+        m_replay.tickHashes.resize(tick);
+    }
+    m_replay.tickHashes.push_back(stateHash);
+}
+
+ReplayResult ReplayPlayer::play(const Replay& replay) {
+    ReplayResult result;
+
+    LevelManager levels;
+    levels.setGameDifficulty(replay.difficulty);
+    levels.setRandomSeed(replay.levelSeed);
+    levels.initialize(replay.screenWidth, replay.screenHeight);
+    if (!levels.loadLevel(replay.levelId)) {
+        return result;
+    }
+
+    PhysicsWorld physics;
+    if (!physics.initialize()) {
+        return result;
+    }
+    physics.setTickRate(replay.tickRate);
+    physics.setStepBudget(PHYSICS_MAX_SUBSTEPS, 0.0f);
+
+    LevelSimulation simulation(&physics, &levels);
+    if (!simulation.setupLevel(replay.gravityMode, replay.paintDiffusion)) {
+        return result;
+    }
+    simulation.setStrokeLimit(replay.strokeLimit);
+    result.loaded = true;
+
+    ReplayRecorder verify;
+    verify.begin(replay);
+    simulation.setRecorder(&verify);
+
+    auto start = std::chrono::steady_clock::now();
+
+    size_t nextStroke = 0;
+    uint64_t tickCount = replay.tickHashes.size();
+    for (uint64_t tick = 0; tick < tickCount; ++tick) {
+        while (nextStroke < replay.strokes.size() && replay.strokes[nextStroke].tick <= tick) {
+            simulation.commitStroke(replay.strokes[nextStroke++].stroke);
+        }
+
+        // Exactly one fixed tick per update
+        simulation.update(physics.getTimestep());
+        result.ticks = tick + 1;
+
+        const auto& hashes = verify.getReplay().tickHashes;
+        if (result.matched && (hashes.size() <= tick || hashes[tick] != replay.tickHashes[tick])) {
+            result.matched = false;
+            result.firstMismatchTick = tick;
+        }
+    }
+
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    Objective* objective = levels.getCurrentLevel() ? levels.getCurrentLevel()->getObjective() : nullptr;
+    result.completed = objective && objective->isComplete();
+    result.failed = objective && objective->isFailed();
+    return result;
+}
+
+} // namespace GravityPaint
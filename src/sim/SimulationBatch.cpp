@@ -0,0 +1,152 @@
+#include "GravityPaint/sim/SimulationBatch.h"
+#include "GravityPaint/sim/LevelSimulation.h"
+#include "GravityPaint/physics/PhysicsWorld.h"
+#include "GravityPaint/level/LevelManager.h"
+#include "GravityPaint/level/Level.h"
+#include "GravityPaint/level/Objective.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace GravityPaint {
+
+SimulationBatch::SimulationBatch(int threadCount)
+    : m_threadCount(threadCount)
+{
+    if (m_threadCount <= 0) {
+        m_threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+#ifdef __EMSCRIPTEN__
+    m_threadCount = 1;  // No pthreads in the web build
+#endif
+}
+
+size_t SimulationBatch::addJob(const SimulationJob& job) {
+    m_jobs.push_back(job);
+    return m_jobs.size() - 1;
+}
+
+void SimulationBatch::clearJobs() {
+    m_jobs.clear();
+    m_results.clear();
+}
+
+void SimulationBatch::run() {
+    m_results.assign(m_jobs.size(), SimulationResult());
+    m_stats = SimulationBatchStats();
+
+    int workers = std::min(m_threadCount, static_cast<int>(m_jobs.size()));
+    m_stats.threadCount = std::max(1, workers);
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Workers pull the next job index until the queue is drained
+    std::atomic<size_t> nextJob{0};
+    auto worker = [this, &nextJob]() {
+        for (size_t i = nextJob++; i < m_jobs.size(); i = nextJob++) {
+            m_results[i] = runJob(m_jobs[i]);
+        }
+    };
+
+    if (workers <= 1) {
+        worker();
+    } else {
+        std::vector<std::thread> threads;
+        threads.reserve(workers);
+        for (int i = 0; i < workers; ++i) {
+            threads.emplace_back(worker);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    m_stats.wallSeconds = std::chrono::duration<double>(end - start).count();
+
+    for (const auto& result : m_results) {
+        m_stats.totalTicks += result.ticks;
+    }
+    if (m_stats.wallSeconds > 0.0) {
+        m_stats.worldTicksPerSecond = m_stats.totalTicks / m_stats.wallSeconds;
+    }
+}
+
+SimulationResult SimulationBatch::runJob(const SimulationJob& job) {
+    SimulationResult result;
+
+    LevelManager levels;
+    levels.setGameDifficulty(job.difficulty);
+    levels.initialize(job.screenWidth, job.screenHeight);
+    if (!levels.loadLevel(job.levelId)) {
+        result.failed = true;
+        return result;
+    }
+
+    PhysicsWorld physics;
+    if (!physics.initialize()) {
+        result.failed = true;
+        return result;
+    }
+    physics.setStepBudget(PHYSICS_MAX_SUBSTEPS, 0.0f);  // No wall-clock cutoff offline
+
+    LevelSimulation simulation(&physics, &levels);
+    if (!simulation.setupLevel(job.gravityMode, 0.0f)) {
+        result.failed = true;
+        return result;
+    }
+    simulation.setStrokeLimit(job.gravityMode == GravityMode::Paint ? MAX_PAINT_STROKES : MAX_ACTIVE_STROKES);
+
+    Level* level = levels.getCurrentLevel();
+    float tick = physics.getTimestep();
+    size_t nextStroke = 0;
+
+    int maxTicks = static_cast<int>(job.maxTime / tick);
+    for (int i = 0; i < maxTicks; ++i) {
+        float time = i * tick;
+
+        // Commit scripted strokes that are due
+        while (nextStroke < job.strokes.size() && job.strokes[nextStroke].time <= time) {
+            simulation.commitStroke(job.strokes[nextStroke++].stroke);
+        }
+
+        simulation.update(tick);
+
+        result.ticks = i + 1;
+        result.time = result.ticks * tick;
+
+        Objective* objective = level->getObjective();
+        if (objective && objective->isComplete()) {
+            result.completed = true;
+            break;
+        }
+        if (objective && objective->isFailed()) {
+            result.failed = true;
+            break;
+        }
+    }
+
+    result.stateHash = physics.computeStateHash();
+    return result;
+}
+
+GravityStroke SimulationBatch::makeSwipe(const Vec2& start, const Vec2& end, int samples) {
+    GravityStroke stroke;
+    samples = std::max(samples, 2);
+    for (int i = 0; i < samples; ++i) {
+        stroke.points.push_back(Vec2::lerp(start, end, static_cast<float>(i) / (samples - 1)));
+    }
+
+    Vec2 delta = end - start;
+    float distance = delta.length();
+    stroke.direction = delta.normalized();
+    stroke.strength = std::min(distance / MAX_SWIPE_DISTANCE, 1.0f) * MAX_GRAVITY_STRENGTH;
+    stroke.lifetime = 0;
+    stroke.maxLifetime = GRAVITY_STROKE_LIFETIME;
+    stroke.isActive = true;
+    stroke.color = Color::cyan();
+    return stroke;
+}
+
+} // namespace GravityPaint
@@ -0,0 +1,97 @@
+#include "GravityPaint/sim/LevelSimulation.h"
+#include "GravityPaint/sim/SimulationBatch.h"
+#include "GravityPaint/physics/PhysicsWorld.h"
+#include "GravityPaint/level/LevelManager.h"
+#include "TestCheck.h"
+#include <cstdlib>
+#include <new>
+
+using namespace GravityPaint;
+
+// Counts every operator new in the process while enabled. Box2D's block
+// allocator goes through malloc and is not counted; this test covers the
+// game's own per-tick work.
+namespace {
+
+bool g_counting = false;
+size_t g_allocations = 0;
+
+void* countedAlloc(std::size_t size) {
+    if (g_counting) {
+        ++g_allocations;
+    }
+    void* memory = std::malloc(size ? size : 1);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+
+namespace {
+
+constexpr int LEVEL_ID = 20;          // Five objects with staggered spawns
+constexpr int WARMUP_TICKS = 900;     // Past the last delayed spawn
+constexpr int MEASURED_UPDATES = 600;
+
+void testSteadyStateUpdatesDontAllocate() {
+    LevelManager levels;
+    levels.setRandomSeed(1234);
+    levels.initialize(DEFAULT_SCREEN_WIDTH, DEFAULT_SCREEN_HEIGHT);
+    CHECK(levels.loadLevel(LEVEL_ID));
+
+    PhysicsWorld physics;
+    CHECK(physics.initialize());
+    physics.setStepBudget(PHYSICS_MAX_SUBSTEPS, 0.0f);
+
+    LevelSimulation simulation(&physics, &levels);
+    CHECK(simulation.setupLevel(GravityMode::Fields, 0.0f));
+
+    // Corner to corner, so every field's bounds cover the whole level and
+    // every object pairs with every field on every tick. The strokes
+    // outlive the test so the measured frames still evaluate their fields.
+    float width = static_cast<float>(DEFAULT_SCREEN_WIDTH);
+    float height = static_cast<float>(DEFAULT_SCREEN_HEIGHT);
+    const Vec2 corners[][2] = {
+        {Vec2(0.0f, 0.0f), Vec2(width, height)},
+        {Vec2(width, 0.0f), Vec2(0.0f, height)},
+        {Vec2(0.0f, height), Vec2(width, 0.0f)},
+    };
+    for (const auto& corner : corners) {
+        GravityStroke stroke = SimulationBatch::makeSwipe(corner[0], corner[1], 16);
+        stroke.maxLifetime = 1000.0f;
+        simulation.commitStroke(stroke);
+    }
+
+    float timestep = physics.getTimestep();
+    for (int i = 0; i < WARMUP_TICKS; ++i) {
+        simulation.update(timestep);
+    }
+
+    g_allocations = 0;
+    g_counting = true;
+    for (int i = 0; i < MEASURED_UPDATES; ++i) {
+        simulation.update(timestep);
+    }
+    g_counting = false;
+
+    if (g_allocations != 0) {
+        std::fprintf(stderr, "%zu allocations over %d updates\n", g_allocations, MEASURED_UPDATES);
+    }
+    CHECK(g_allocations == 0);
+    CHECK(simulation.getStrokes().size() == 3);
+    CHECK(physics.getObjects().size() > 0);
+}
+
+} // namespace
+
+int main() {
+    testSteadyStateUpdatesDontAllocate();
+    return testResult();
+}
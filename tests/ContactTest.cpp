@@ -0,0 +1,158 @@
+#include "GravityPaint/physics/PhysicsWorld.h"
+#include "TestCheck.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using namespace GravityPaint;
+
+namespace {
+
+constexpr int OBJECT_COUNT = 40;
+
+// Balls that never step; only their ids and energies are used
+std::vector<PhysicsObject*> makeObjects(PhysicsWorld& world) {
+    std::vector<PhysicsObject*> objects;
+    for (int i = 0; i < OBJECT_COUNT; ++i) {
+        ObjectHandle handle = world.createObject(ObjectType::Ball,
+                                                 Vec2(50.0f + 40.0f * static_cast<float>(i), 100.0f), 0.6f);
+        objects.push_back(world.getObject(handle));
+    }
+    return objects;
+}
+
+ContactListener::Record makeRecord(PhysicsObject* a, PhysicsObject* b, float x, float impulse, bool began) {
+    ContactListener::Record record;
+    record.a = a;
+    record.b = b;
+    record.point = b2Vec2(x, 1.0f);
+    record.normalImpulse = impulse;
+    record.began = began;
+    return record;
+}
+
+// Far more pairs than CONTACT_EVENT_CAPACITY, each reported three times
+// in both orders: the listener keeps one merged record per pair
+void testListenerMergesPerPair() {
+    PhysicsWorld world;
+    CHECK(world.initialize());
+    std::vector<PhysicsObject*> objects = makeObjects(world);
+
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < OBJECT_COUNT; ++i) {
+        for (int j = i + 1; j < OBJECT_COUNT; ++j) {
+            pairs.emplace_back(i, j);
+        }
+    }
+    CHECK(pairs.size() > 2 * static_cast<size_t>(CONTACT_EVENT_CAPACITY));
+
+    ContactListener listener(&world);
+    listener.reserve(pairs.size());
+    for (int pass = 0; pass < 3; ++pass) {
+        for (const auto& pair : pairs) {
+            PhysicsObject* a = objects[pair.first];
+            PhysicsObject* b = objects[pair.second];
+            if (pass == 1) std::swap(a, b);
+            // The middle pass hits hardest; only the first one begins
+            float impulse = pass == 1 ? 3.0f : 1.0f;
+            listener.record(a, b, b2Vec2(static_cast<float>(pass), 0.0f), impulse, pass == 0);
+        }
+    }
+
+    CHECK(listener.getDroppedCount() == 0);
+    const std::vector<ContactListener::Record>& records = listener.getRecords();
+    CHECK(records.size() == pairs.size());
+    for (size_t i = 0; i < records.size() && i < pairs.size(); ++i) {
+        CHECK(records[i].a == objects[pairs[i].first]);
+        CHECK(records[i].b == objects[pairs[i].second]);
+        CHECK(records[i].began);
+        CHECK(records[i].normalImpulse == 3.0f);
+        CHECK(records[i].point.x == 1.0f);
+    }
+
+    // A cleared listener starts over with the same pairs
+    listener.clear();
+    CHECK(listener.getRecords().empty());
+    listener.record(objects[1], objects[0], b2Vec2(0.0f, 0.0f), 2.0f, false);
+    listener.record(objects[0], objects[1], b2Vec2(0.0f, 0.0f), 1.0f, false);
+    CHECK(listener.getRecords().size() == 1);
+    CHECK(!listener.getRecords()[0].began);
+
+    // Without room reserved, pairs past the minimum capacity are counted
+    ContactListener small(&world);
+    for (const auto& pair : pairs) {
+        small.record(objects[pair.first], objects[pair.second], b2Vec2(0.0f, 0.0f), 1.0f, true);
+    }
+    CHECK(small.getRecords().size() == static_cast<size_t>(CONTACT_EVENT_CAPACITY));
+    CHECK(small.getDroppedCount() == pairs.size() - CONTACT_EVENT_CAPACITY);
+}
+
+// Records fed straight to the drain's merge: pairs come out ordered by
+// id with one event each, and only hard hits move energy
+void testMergeContacts() {
+    PhysicsWorld world;
+    CHECK(world.initialize());
+    std::vector<PhysicsObject*> objects = makeObjects(world);
+    PhysicsObject* low = objects[0];
+    PhysicsObject* high = objects[1];
+    PhysicsObject* soft = objects[2];
+    PhysicsObject* last = objects[3];
+    low->setEnergy(0.0f);
+    high->setEnergy(50.0f);
+    soft->setEnergy(80.0f);
+    last->setEnergy(10.0f);
+
+    const float hard = CONTACT_IMPULSE_THRESHOLD + 20.0f;
+    std::vector<ContactListener::Record> records = {
+        makeRecord(last, soft, 1.0f, CONTACT_IMPULSE_THRESHOLD, false),
+        makeRecord(high, low, 2.0f, 5.0f, false),
+        makeRecord(low, high, 3.0f, hard, false),
+        makeRecord(high, low, 4.0f, hard, true),  // Same impulse: the earlier point stays
+        makeRecord(soft, low, 5.0f, 0.5f, true),
+    };
+
+    std::vector<ContactEvent> events;
+    PhysicsWorld::mergeContacts(records, 77, events);
+
+    CHECK(events.size() == 3);
+    if (events.size() == 3) {
+        CHECK(events[0].idA == low->getId() && events[0].idB == high->getId());
+        CHECK(events[1].idA == low->getId() && events[1].idB == soft->getId());
+        CHECK(events[2].idA == soft->getId() && events[2].idB == last->getId());
+        for (const ContactEvent& event : events) {
+            CHECK(event.idA < event.idB);
+            CHECK(event.tick == 77);
+        }
+
+        CHECK(events[0].began);
+        CHECK(events[0].normalImpulse == hard);
+        CHECK_NEAR(events[0].point.x, PhysicsWorld::toPixels(b2Vec2(3.0f, 1.0f)).x, 1e-4);
+        CHECK(events[1].began);
+        CHECK(!events[2].began);
+        CHECK(events[2].normalImpulse == CONTACT_IMPULSE_THRESHOLD);
+    }
+
+    // Only the hard pair transfers, from the charged object to the empty one
+    float transfer = std::min(hard * 0.1f, 10.0f) * ENERGY_TRANSFER_RATE;
+    CHECK_NEAR(high->getEnergy(), 50.0f - transfer, 1e-4);
+    CHECK_NEAR(low->getEnergy(), transfer, 1e-4);
+    CHECK_NEAR(soft->getEnergy(), 80.0f, 1e-6);
+    CHECK_NEAR(last->getEnergy(), 10.0f, 1e-6);
+
+    // Merging the same input again gives the same events
+    std::vector<ContactEvent> again;
+    PhysicsWorld::mergeContacts(records, 77, again);
+    CHECK(again.size() == events.size());
+    for (size_t i = 0; i < again.size() && i < events.size(); ++i) {
+        CHECK(again[i].idA == events[i].idA && again[i].idB == events[i].idB);
+        CHECK(again[i].normalImpulse == events[i].normalImpulse);
+    }
+}
+
+} // namespace
+
+int main() {
+    testListenerMergesPerPair();
+    testMergeContacts();
+    return testResult();
+}
@@ -0,0 +1,189 @@
+#include "GravityPaint/physics/DeformableSurface.h"
+#include "TestCheck.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+using namespace GravityPaint;
+
+namespace {
+
+// Springs with both nodes in columns [first, last]
+size_t springsInside(const DeformableSurface& surface, int resolutionX, int first, int last) {
+    size_t count = 0;
+    for (size_t i = 0; i < surface.getSpringCount(); ++i) {
+        int columnA = surface.getSpringNodeA(i) % resolutionX;
+        int columnB = surface.getSpringNodeB(i) % resolutionX;
+        if (std::min(columnA, columnB) >= first && std::max(columnA, columnB) <= last) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+void testAwakeRegionSprings() {
+    const int resolutionX = 10;
+    const int resolutionY = 5;
+    DeformableSurface surface(Vec2(0.0f, 0.0f), 200.0f, 100.0f, resolutionX, resolutionY);
+
+    CHECK(!surface.isAwake());
+    CHECK(surface.getActiveSpringCount() == 0);
+
+    for (int first = 0; first < resolutionX; ++first) {
+        for (int last = first; last < resolutionX; ++last) {
+            surface.reset();
+            surface.wakeColumns(first, last);
+            CHECK(surface.getAwakeColumnCount() == last - first + 1);
+            CHECK(surface.getActiveSpringCount() == springsInside(surface, resolutionX, first, last));
+        }
+    }
+
+    // A single awake column still solves its own vertical springs
+    surface.reset();
+    surface.wakeColumns(4, 4);
+    CHECK(surface.getActiveSpringCount() == static_cast<size_t>(resolutionY - 1));
+
+    surface.reset();
+    surface.wakeColumns(0, resolutionX - 1);
+    CHECK(surface.getActiveSpringCount() == surface.getSpringCount());
+}
+
+void testImpactSettles() {
+    DeformableSurface surface(Vec2(0.0f, 0.0f), 200.0f, 100.0f, 10, 5);
+    surface.applyImpact(Vec2(0.0f, 0.0f), 200.0f);
+    CHECK(surface.isAwake());
+    CHECK(surface.getTotalDeformation() >= 0.0f);
+
+    for (int i = 0; i < 60 * 30 && surface.isAwake(); ++i) {
+        surface.update(1.0f / 60.0f);
+    }
+    CHECK(!surface.isAwake());
+}
+
+// Distance from point to the nearest node, by scanning every node
+float nearestNodeDistance(const DeformableSurface& surface, const Vec2& point) {
+    float best = std::numeric_limits<float>::max();
+    for (size_t i = 0; i < surface.getNodeCount(); ++i) {
+        best = std::min(best, (surface.getNodePosition(i) - point).length());
+    }
+    return best;
+}
+
+bool anyNodeWithin(const DeformableSurface& surface, const Vec2& point, float threshold) {
+    for (size_t i = 0; i < surface.getNodeCount(); ++i) {
+        Vec2 offset = surface.getNodePosition(i) - point;
+        if (offset.x * offset.x + offset.y * offset.y < threshold * threshold) return true;
+    }
+    return false;
+}
+
+// Deformation of some node at the nearest distance; ties may go either way
+bool isNearestDeformation(const DeformableSurface& surface, const Vec2& point, float deformation) {
+    float nearest = nearestNodeDistance(surface, point);
+    for (size_t i = 0; i < surface.getNodeCount(); ++i) {
+        if ((surface.getNodePosition(i) - point).length() > nearest + 1e-3f) continue;
+        float nodeDeformation = (surface.getNodePosition(i) - surface.getNodeRestPosition(i)).length();
+        if (std::fabs(nodeDeformation - deformation) <= 1e-4f) return true;
+    }
+    return false;
+}
+
+// The grid-backed queries against an all-node scan while the surface is
+// deformed, on a lattice of points reaching well past its bounds
+void testQueriesMatchNodeScan() {
+    DeformableSurface surface(Vec2(0.0f, 0.0f), 200.0f, 100.0f, 20, 10);
+    surface.applyImpact(Vec2(-20.0f, 10.0f), 300.0f);
+    for (int i = 0; i < 10; ++i) {
+        surface.update(1.0f / 60.0f);
+    }
+    CHECK(surface.isAwake());
+    CHECK(surface.getTotalDeformation() > 1.0f);
+
+    Rect bounds = surface.getBounds();
+    int outside = 0;
+    for (float y = bounds.y - 80.0f; y <= bounds.y + bounds.h + 80.0f; y += 7.3f) {
+        for (float x = bounds.x - 80.0f; x <= bounds.x + bounds.w + 80.0f; x += 7.3f) {
+            Vec2 point(x, y);
+            if (!bounds.contains(point)) ++outside;
+
+            for (float threshold : {3.0f, 20.0f, 45.0f}) {
+                CHECK(surface.isPointNear(point, threshold) == anyNodeWithin(surface, point, threshold));
+            }
+            CHECK_NEAR((surface.getNearestPoint(point) - point).length(), nearestNodeDistance(surface, point), 1e-3);
+            CHECK(isNearestDeformation(surface, point, surface.getDeformationAt(point)));
+        }
+    }
+    CHECK(outside > 0);
+}
+
+// The stiffness that blows up the explicit solver, under XPBD with a
+// single iteration and one 1/60 s step per frame: every node stays
+// finite and within a mesh cell of rest for five seconds of impacts
+void testStiffXpbdStaysBounded() {
+    DeformableSurface surface(Vec2(0.0f, 0.0f), 200.0f, 100.0f, 20, 10);
+    surface.setSolver(SurfaceSolver::XPBD);
+    surface.setIterations(1);
+    surface.setStiffness(50000.0f);
+
+    float peak = 0.0f;
+    bool finite = true;
+    for (int frame = 0; frame < 60 * 5; ++frame) {
+        if (frame % 60 == 0) {
+            surface.applyImpact(Vec2(-40.0f + 20.0f * static_cast<float>(frame / 60), 0.0f), 300.0f);
+        }
+        surface.wakeColumns(0, 19);
+        surface.update(1.0f / 60.0f);
+
+        for (size_t i = 0; i < surface.getNodeCount(); ++i) {
+            Vec2 offset = surface.getNodePosition(i) - surface.getNodeRestPosition(i);
+            finite = finite && std::isfinite(offset.x) && std::isfinite(offset.y);
+            peak = std::max(peak, offset.length());
+        }
+    }
+    CHECK(finite);
+    CHECK(peak > 0.0f);
+    CHECK(peak < 10.0f);
+}
+
+// Far too stiff for the explicit solver: the nodes blow up, but the
+// node grid and queries must survive it
+void testBlownUpSurfaceStaysQueryable() {
+    DeformableSurface surface(Vec2(0.0f, 0.0f), 200.0f, 100.0f, 20, 10);
+    surface.setStiffness(50000.0f);
+    surface.applyImpact(Vec2(0.0f, 0.0f), 300.0f);
+    for (int i = 0; i < 120; ++i) {
+        surface.wakeColumns(0, 19);
+        surface.update(1.0f / 60.0f);
+    }
+
+    // The fixed border never moves, so its corner is still found
+    Vec2 corner = surface.getNodePosition(0);
+    CHECK(surface.isPointNear(corner, 1.0f));
+    CHECK_NEAR((surface.getNearestPoint(corner) - corner).length(), 0.0, 1e-4);
+
+    // Whatever the rest became, the nearest point is one of the nodes
+    Vec2 query(10.0f, 10.0f);
+    Vec2 nearest = surface.getNearestPoint(query);
+    bool isNode = false;
+    for (size_t i = 0; i < surface.getNodeCount(); ++i) {
+        Vec2 position = surface.getNodePosition(i);
+        isNode = isNode || std::memcmp(&position, &nearest, sizeof(Vec2)) == 0;
+    }
+    CHECK(isNode);
+
+    surface.reset();
+    CHECK(surface.isPointNear(Vec2(0.0f, 0.0f)));
+    CHECK_NEAR(surface.getDeformationAt(Vec2(0.0f, 0.0f)), 0.0, 1e-4);
+}
+
+} // namespace
+
+int main() {
+    testAwakeRegionSprings();
+    testImpactSettles();
+    testQueriesMatchNodeScan();
+    testStiffXpbdStaysBounded();
+    testBlownUpSurfaceStaysQueryable();
+    return testResult();
+}
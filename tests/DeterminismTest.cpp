@@ -0,0 +1,187 @@
+#include "GravityPaint/sim/LevelSimulation.h"
+#include "GravityPaint/sim/Replay.h"
+#include "GravityPaint/sim/SimulationBatch.h"
+#include "GravityPaint/physics/PhysicsWorld.h"
+#include "GravityPaint/level/LevelManager.h"
+#include "TestCheck.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace GravityPaint;
+
+namespace {
+
+constexpr uint32_t LEVEL_SEED = 1234;
+constexpr uint64_t TICKS = 600;
+constexpr uint64_t SECOND_STROKE_TICK = 120;
+
+// Steps level 1 with frames of frameDelta until TICKS fixed ticks have
+// run and returns what the recorder saw: the tick each stroke was bound
+// at and the state hash after every tick
+Replay runLevel(float frameDelta) {
+    Replay replay;
+
+    LevelManager levels;
+    levels.setRandomSeed(LEVEL_SEED);
+    levels.initialize(DEFAULT_SCREEN_WIDTH, DEFAULT_SCREEN_HEIGHT);
+    if (!levels.loadLevel(1)) return replay;
+
+    PhysicsWorld physics;
+    if (!physics.initialize()) return replay;
+    physics.setStepBudget(PHYSICS_MAX_SUBSTEPS, 0.0f);
+
+    LevelSimulation simulation(&physics, &levels);
+    if (!simulation.setupLevel(GravityMode::Fields, 0.0f)) return replay;
+
+    ReplayRecorder recorder;
+    recorder.begin(replay);
+    simulation.setRecorder(&recorder);
+
+    float width = static_cast<float>(DEFAULT_SCREEN_WIDTH);
+    float height = static_cast<float>(DEFAULT_SCREEN_HEIGHT);
+    simulation.commitStroke(SimulationBatch::makeSwipe(Vec2(width * 0.2f, height * 0.3f),
+                                                       Vec2(width * 0.8f, height * 0.5f)));
+
+    // Every frame delta passes through this tick exactly, so the second
+    // stroke is bound at the same tick in each run
+    bool secondCommitted = false;
+    while (physics.getTick() < TICKS) {
+        if (!secondCommitted && physics.getTick() == SECOND_STROKE_TICK) {
+            simulation.commitStroke(SimulationBatch::makeSwipe(Vec2(width * 0.7f, height * 0.6f),
+                                                               Vec2(width * 0.4f, height * 0.7f)));
+            secondCommitted = true;
+        }
+        simulation.update(frameDelta);
+    }
+
+    simulation.setRecorder(nullptr);
+    return recorder.getReplay();
+}
+
+void testFrameRateIndependence() {
+    const float frameDeltas[] = {1.0f / 60.0f, 1.0f / 30.0f, 1.0f / 144.0f};
+
+    Replay reference = runLevel(frameDeltas[0]);
+    CHECK(reference.tickHashes.size() >= TICKS);
+    CHECK(reference.strokes.size() == 2);
+    if (reference.strokes.size() == 2) {
+        CHECK(reference.strokes[0].tick == 0);
+        CHECK(reference.strokes[1].tick == SECOND_STROKE_TICK);
+    }
+
+    for (float frameDelta : frameDeltas) {
+        Replay run = runLevel(frameDelta);
+        CHECK(run.tickHashes.size() >= TICKS);
+        CHECK(run.strokes.size() == reference.strokes.size());
+        for (size_t i = 0; i < std::min(run.strokes.size(), reference.strokes.size()); ++i) {
+            CHECK(run.strokes[i].tick == reference.strokes[i].tick);
+        }
+
+        // Report only the first divergence; everything after it follows
+        size_t ticks = std::min({run.tickHashes.size(), reference.tickHashes.size(), static_cast<size_t>(TICKS)});
+        for (size_t tick = 0; tick < ticks; ++tick) {
+            if (run.tickHashes[tick] != reference.tickHashes[tick]) {
+                std::fprintf(stderr, "frame delta %.5f diverges at tick %zu\n", frameDelta, tick);
+                CHECK(run.tickHashes[tick] == reference.tickHashes[tick]);
+                break;
+            }
+        }
+    }
+}
+
+std::vector<char> readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string& path, const std::vector<char>& bytes) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+template <typename T>
+void patch(std::vector<char>& bytes, size_t offset, T value) {
+    std::memcpy(bytes.data() + offset, &value, sizeof(T));
+}
+
+// A saved replay loads back as written; damaged counts and enums make
+// load() fail before it allocates anything for them
+void testReplayLoadRejectsCorruptFiles() {
+    const std::string path = "DeterminismTest.replay";
+
+    Replay replay;
+    replay.difficulty = Difficulty::Hard;
+    replay.gravityMode = GravityMode::Paint;
+    replay.levelSeed = LEVEL_SEED;
+    ReplayStroke entry;
+    entry.tick = 12;
+    entry.stroke = SimulationBatch::makeSwipe(Vec2(10.0f, 20.0f), Vec2(300.0f, 40.0f));
+    replay.strokes.push_back(entry);
+    replay.tickHashes = {1, 2, 3};
+    CHECK(replay.save(path));
+
+    Replay loaded;
+    CHECK(loaded.load(path));
+    CHECK(loaded.difficulty == Difficulty::Hard);
+    CHECK(loaded.gravityMode == GravityMode::Paint);
+    CHECK(loaded.levelSeed == LEVEL_SEED);
+    CHECK(loaded.strokes.size() == 1);
+    CHECK(loaded.tickHashes == replay.tickHashes);
+    if (loaded.strokes.size() == 1) {
+        CHECK(loaded.strokes[0].tick == 12);
+        CHECK(loaded.strokes[0].stroke.points.size() == entry.stroke.points.size());
+    }
+
+    // Header: magic, version, levelId, difficulty, gravityMode, six more
+    // four-byte fields, then the stroke count and the first stroke's tick
+    // and point count. The hash count sits just before the hashes.
+    const std::vector<char> original = readFile(path);
+    const size_t difficultyOffset = 3 * sizeof(uint32_t);
+    const size_t gravityModeOffset = difficultyOffset + sizeof(Difficulty);
+    const size_t strokeCountOffset = 12 * sizeof(uint32_t);
+    const size_t pointCountOffset = strokeCountOffset + sizeof(uint32_t) + sizeof(uint64_t);
+    const size_t hashCountOffset = original.size() - 3 * sizeof(uint64_t) - sizeof(uint32_t);
+
+    struct Corruption {
+        const char* name;
+        size_t offset;
+        uint32_t value;
+    } corruptions[] = {
+        {"difficulty", difficultyOffset, 7},
+        {"gravity mode", gravityModeOffset, 0xFFFFFFFFu},
+        {"stroke count", strokeCountOffset, 0xFFFFFFFFu},
+        {"point count", pointCountOffset, 0x40000000u},
+        {"hash count", hashCountOffset, 0x20000000u},
+    };
+    for (const Corruption& corruption : corruptions) {
+        std::vector<char> bytes = original;
+        patch(bytes, corruption.offset, corruption.value);
+        writeFile(path, bytes);
+        Replay damaged;
+        if (damaged.load(path)) {
+            std::fprintf(stderr, "replay with a bad %s loaded\n", corruption.name);
+            CHECK(false);
+        }
+    }
+
+    // One hash short of what the count promises
+    std::vector<char> truncated(original.begin(), original.end() - sizeof(uint64_t));
+    writeFile(path, truncated);
+    Replay damaged;
+    CHECK(!damaged.load(path));
+
+    std::remove(path.c_str());
+}
+
+} // namespace
+
+int main() {
+    testFrameRateIndependence();
+    testReplayLoadRejectsCorruptFiles();
+    return testResult();
+}
@@ -0,0 +1,95 @@
+#include "GravityPaint/physics/PhysicsWorld.h"
+#include "GravityPaint/physics/PhysicsObject.h"
+#include "TestCheck.h"
+
+using namespace GravityPaint;
+
+namespace {
+
+constexpr float WORLD_WIDTH = 800.0f;
+constexpr float WORLD_HEIGHT = 600.0f;
+
+void stepTicks(PhysicsWorld& world, int ticks) {
+    for (int i = 0; i < ticks; ++i) {
+        world.update(world.getTimestep());
+    }
+}
+
+// Two goals overlapping on the floor: a ball that lands in both counts
+// once, stays counted after it settles and freezes (turning static ends
+// its sensor contacts), and a ball that lands beside them never counts
+void testOverlappingGoalsCountOnce() {
+    PhysicsWorld world;
+    CHECK(world.initialize());
+    world.setStepBudget(PHYSICS_MAX_SUBSTEPS, 0.0f);
+    world.createBoundaries(WORLD_WIDTH, WORLD_HEIGHT);
+    world.createGoalZone(Vec2(400.0f, 560.0f), Vec2(200.0f, 80.0f));
+    world.createGoalZone(Vec2(420.0f, 560.0f), Vec2(200.0f, 80.0f));
+
+    ObjectHandle scoring = world.createObject(ObjectType::Ball, Vec2(410.0f, 300.0f), 1.0f);
+    ObjectHandle missing = world.createObject(ObjectType::Ball, Vec2(700.0f, 300.0f), 1.0f);
+
+    for (int i = 0; i < 60 * 10 && !world.getObject(scoring)->hasReachedGoal(); ++i) {
+        stepTicks(world, 1);
+    }
+    const PhysicsObject* ball = world.getObject(scoring);
+    CHECK(ball->hasReachedGoal());
+    CHECK(ball->isTouchingGoal());
+    CHECK(world.isObjectInGoal(ball));
+    CHECK(world.getGoalCount() == 1);
+
+    for (int i = 0; i < 60 * 20 && !world.getObject(scoring)->isFrozen(); ++i) {
+        stepTicks(world, 1);
+    }
+    ball = world.getObject(scoring);
+    CHECK(ball->isFrozen());
+    CHECK(!ball->isTouchingGoal());
+    CHECK(ball->hasReachedGoal());
+    CHECK(world.getGoalCount() == 1);
+
+    stepTicks(world, 60);
+    CHECK(world.getObject(scoring)->hasReachedGoal());
+    CHECK(!world.getObject(missing)->hasReachedGoal());
+    CHECK(!world.getObject(missing)->isTouchingGoal());
+    CHECK(world.getGoalCount() == 1);
+
+    // Destroying a scored object takes it off the count
+    world.destroyObject(scoring);
+    CHECK(world.getGoalCount() == 0);
+}
+
+// A goal overlapping only the edge of a ball: the sensor touches it, but
+// it scores only once its centre is inside, with no new contact needed
+void testGoalNeedsCentreInside() {
+    PhysicsWorld world;
+    CHECK(world.initialize());
+    world.setStepBudget(PHYSICS_MAX_SUBSTEPS, 0.0f);
+    world.setGlobalGravity(Vec2(0.0f, 0.0f));
+    world.createBoundaries(WORLD_WIDTH, WORLD_HEIGHT);
+
+    // Ball radius is 20 px; the goal spans x 415..475
+    ObjectHandle handle = world.createObject(ObjectType::Ball, Vec2(400.0f, 300.0f), 1.0f);
+    world.createGoalZone(Vec2(445.0f, 300.0f), Vec2(60.0f, 60.0f));
+
+    stepTicks(world, 10);
+    PhysicsObject* ball = world.getObject(handle);
+    CHECK(ball->isTouchingGoal());
+    CHECK(!ball->hasReachedGoal());
+    CHECK(!world.isObjectInGoal(ball));
+    CHECK(world.getGoalCount() == 0);
+
+    ball->setPosition(Vec2(445.0f, 300.0f));
+    stepTicks(world, 1);
+    ball = world.getObject(handle);
+    CHECK(ball->hasReachedGoal());
+    CHECK(world.isObjectInGoal(ball));
+    CHECK(world.getGoalCount() == 1);
+}
+
+} // namespace
+
+int main() {
+    testOverlappingGoalsCountOnce();
+    testGoalNeedsCentreInside();
+    return testResult();
+}
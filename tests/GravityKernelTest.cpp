@@ -0,0 +1,123 @@
+#include "GravityPaint/physics/GravityKernel.h"
+#include "GravityPaint/physics/GravityField.h"
+#include "TestCheck.h"
+#include <cmath>
+#include <vector>
+
+using namespace GravityPaint;
+
+namespace {
+
+const ZoneType ZONE_TYPES[] = {
+    ZoneType::Normal, ZoneType::Boost, ZoneType::Slow, ZoneType::Reverse,
+    ZoneType::Attract, ZoneType::Repel, ZoneType::Zero,
+};
+
+// Points on rings around center out to 1.5 radii, so every batch mixes
+// lanes inside, outside and (with the center itself) at zero distance
+void makePositions(const Vec2& center, float radius, size_t count,
+                   std::vector<float>& posX, std::vector<float>& posY) {
+    posX.resize(count);
+    posY.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (i == 0) {
+            posX[i] = center.x;
+            posY[i] = center.y;
+            continue;
+        }
+        float distance = radius * 1.5f * static_cast<float>(i % 17) / 16.0f;
+        float angle = static_cast<float>(i) * 2.39996f;
+        posX[i] = center.x + distance * std::cos(angle);
+        posY[i] = center.y + distance * std::sin(angle);
+    }
+}
+
+// The kernel adds into the force arrays, so they start from a known
+// non-zero value and the reference adds onto the same value
+void checkMatchesField(const GravityField& field, size_t count) {
+    std::vector<float> posX, posY;
+    makePositions(field.getPosition(), field.getRadius(), count, posX, posY);
+
+    std::vector<float> forceX(count, 1.0f);
+    std::vector<float> forceY(count, -2.0f);
+    accumulateFieldForces(field, posX.data(), posY.data(), forceX.data(), forceY.data(), count);
+
+    for (size_t i = 0; i < count; ++i) {
+        Vec2 expected = field.calculateForce(Vec2(posX[i], posY[i]));
+        float toleranceX = 1e-4f * std::max(1.0f, std::fabs(expected.x));
+        float toleranceY = 1e-4f * std::max(1.0f, std::fabs(expected.y));
+        CHECK_NEAR(forceX[i], 1.0f + expected.x, toleranceX);
+        CHECK_NEAR(forceY[i], -2.0f + expected.y, toleranceY);
+    }
+}
+
+void testPointFields() {
+    // Counts below, at and past a multiple of four exercise the scalar tail
+    const size_t counts[] = {1, 2, 3, 4, 5, 7, 8, 13, 64, 257};
+
+    for (ZoneType zone : ZONE_TYPES) {
+        GravityField field(Vec2(300.0f, 400.0f), Vec2(0.6f, 0.8f), 250.0f, 120.0f);
+        field.setZoneType(zone);
+        for (size_t count : counts) {
+            checkMatchesField(field, count);
+        }
+    }
+}
+
+// A wavy stroke through (300, 400) with `count` points
+std::vector<Vec2> makePath(size_t count) {
+    std::vector<Vec2> path(count);
+    for (size_t i = 0; i < count; ++i) {
+        float x = 200.0f + 200.0f * static_cast<float>(i) / static_cast<float>(count - 1);
+        path[i] = Vec2(x, 400.0f + 25.0f * std::sin(x * 0.05f));
+    }
+    return path;
+}
+
+void testPathFields() {
+    // Short paths take the lane-parallel route, long ones the BVH
+    const size_t pointCounts[] = {2, 5, 33, 200};
+
+    for (size_t points : pointCounts) {
+        std::vector<Vec2> path = makePath(points);
+        for (ZoneType zone : ZONE_TYPES) {
+            GravityField field(Vec2(300.0f, 400.0f), Vec2(1.0f, 0.0f), 180.0f, 90.0f);
+            field.setZoneType(zone);
+            field.setPath(path);
+            checkMatchesField(field, 5);
+            checkMatchesField(field, 130);
+        }
+    }
+
+    // A degenerate segment (repeated point) must not break the closest point
+    std::vector<Vec2> repeated = {Vec2(250.0f, 400.0f), Vec2(300.0f, 400.0f), Vec2(300.0f, 400.0f),
+                                  Vec2(350.0f, 420.0f)};
+    GravityField field(Vec2(300.0f, 400.0f), Vec2(0.0f, 1.0f), 120.0f, 80.0f);
+    field.setZoneType(ZoneType::Attract);
+    field.setPath(repeated);
+    checkMatchesField(field, 64);
+}
+
+void testInactiveFieldAddsNothing() {
+    GravityField field(Vec2(0.0f, 0.0f), Vec2(1.0f, 0.0f), 100.0f, 50.0f);
+    field.setActive(false);
+
+    std::vector<float> posX, posY;
+    makePositions(field.getPosition(), field.getRadius(), 9, posX, posY);
+    std::vector<float> forceX(9, 0.0f);
+    std::vector<float> forceY(9, 0.0f);
+    accumulateFieldForces(field, posX.data(), posY.data(), forceX.data(), forceY.data(), 9);
+
+    for (size_t i = 0; i < 9; ++i) {
+        CHECK(forceX[i] == 0.0f && forceY[i] == 0.0f);
+    }
+}
+
+} // namespace
+
+int main() {
+    testPointFields();
+    testPathFields();
+    testInactiveFieldAddsNothing();
+    return testResult();
+}
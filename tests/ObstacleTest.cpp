@@ -0,0 +1,262 @@
+#include "GravityPaint/sim/LevelSimulation.h"
+#include "GravityPaint/physics/PhysicsWorld.h"
+#include "GravityPaint/physics/WorldSnapshot.h"
+#include "GravityPaint/level/LevelManager.h"
+#include "GravityPaint/level/Level.h"
+#include "GravityPaint/Constants.h"
+#include "TestCheck.h"
+#include <cmath>
+#include <vector>
+
+using namespace GravityPaint;
+
+namespace {
+
+constexpr float MOVER_SPEED = 60.0f;      // px/s
+constexpr float MOVER_DISTANCE = 120.0f;  // px each way
+
+// Four static pieces (two boxes, a rotated box, a circle) and two movers,
+// placed by fractions of the level size
+std::vector<ObstacleData> makeObstacles(float width, float height) {
+    std::vector<ObstacleData> obstacles;
+
+    ObstacleData box;
+    box.position = Vec2(width * 0.25f, height * 0.5f);
+    box.size = Vec2(120.0f, 30.0f);
+    obstacles.push_back(box);
+
+    box.position = Vec2(width * 0.75f, height * 0.5f);
+    obstacles.push_back(box);
+
+    ObstacleData tilted = box;
+    tilted.position = Vec2(width * 0.5f, height * 0.7f);
+    tilted.rotation = 0.6f;
+    obstacles.push_back(tilted);
+
+    ObstacleData circle;
+    circle.position = Vec2(width * 0.5f, height * 0.3f);
+    circle.size = Vec2(60.0f, 60.0f);
+    circle.isCircle = true;
+    obstacles.push_back(circle);
+
+    ObstacleData mover = box;
+    mover.position = Vec2(width * 0.3f, height * 0.2f);
+    mover.isMoving = true;
+    mover.moveDirection = Vec2(1.0f, 0.0f);
+    mover.moveSpeed = MOVER_SPEED;
+    mover.moveDistance = MOVER_DISTANCE;
+    obstacles.push_back(mover);
+
+    mover = circle;
+    mover.position = Vec2(width * 0.7f, height * 0.8f);
+    mover.isMoving = true;
+    mover.moveDirection = Vec2(-1.0f, -1.0f);
+    mover.moveSpeed = MOVER_SPEED;
+    mover.moveDistance = MOVER_DISTANCE;
+    obstacles.push_back(mover);
+
+    return obstacles;
+}
+
+// Loads a campaign level with its spawns, zones and obstacles replaced
+// by the given obstacles, and sets it up the way the game does
+bool setupObstacleLevel(LevelManager& levels, LevelSimulation& simulation, bool withObstacles) {
+    levels.setRandomSeed(1234);
+    levels.initialize(DEFAULT_SCREEN_WIDTH, DEFAULT_SCREEN_HEIGHT);
+    if (!levels.loadLevel(5)) return false;
+
+    Level* level = levels.getCurrentLevel();
+    level->clearSpawnPoints();
+    level->clearGravityZones();
+    level->clearObstacles();
+    if (withObstacles) {
+        for (const ObstacleData& obstacle : makeObstacles(level->getWidth(), level->getHeight())) {
+            level->addObstacle(obstacle);
+        }
+    }
+    return simulation.setupLevel(GravityMode::Fields, 0.0f);
+}
+
+// Static, non-sensor body with a fixture over the point, if any
+const b2Body* staticBodyAt(const PhysicsWorld& world, const Vec2& point) {
+    b2Vec2 meters = PhysicsWorld::toMeters(point);
+    for (const b2Body* body = world.getBox2DWorld()->GetBodyList(); body; body = body->GetNext()) {
+        if (body->GetType() != b2_staticBody) continue;
+        for (const b2Fixture* fixture = body->GetFixtureList(); fixture; fixture = fixture->GetNext()) {
+            if (!fixture->IsSensor() && fixture->TestPoint(meters)) return body;
+        }
+    }
+    return nullptr;
+}
+
+int fixtureCount(const b2Body* body) {
+    int count = 0;
+    for (const b2Fixture* fixture = body->GetFixtureList(); fixture; fixture = fixture->GetNext()) {
+        count++;
+    }
+    return count;
+}
+
+// Where the precomputed path has a mover at a tick: out along its travel
+// for half the round trip, then back
+Vec2 expectedMoverPosition(const ObstacleData& mover, uint64_t tick, float timestep) {
+    float period = 2.0f * mover.moveDistance / mover.moveSpeed;
+    uint64_t length = static_cast<uint64_t>(std::lround(period / timestep));
+    float phase = static_cast<float>(tick % length) / static_cast<float>(length);
+    float s = phase < 0.5f ? 2.0f * phase : 2.0f - 2.0f * phase;
+    Vec2 travel = mover.moveDirection * (mover.moveDistance / mover.moveDirection.length());
+    return mover.position + travel * s;
+}
+
+struct MoverPose {
+    Vec2 position;
+    float angle;
+};
+
+// Movers are the only kinematic bodies in these levels, in creation order
+std::vector<const b2Body*> kinematicBodies(const PhysicsWorld& world) {
+    std::vector<const b2Body*> bodies;
+    for (const b2Body* body = world.getBox2DWorld()->GetBodyList(); body; body = body->GetNext()) {
+        if (body->GetType() == b2_kinematicBody) bodies.push_back(body);
+    }
+    return bodies;
+}
+
+std::vector<MoverPose> moverPoses(const PhysicsWorld& world) {
+    std::vector<MoverPose> poses;
+    std::vector<const b2Body*> bodies = kinematicBodies(world);
+    for (size_t i = 0; i < world.getMovingObstacleCount(); ++i) {
+        float angle = i < bodies.size() ? bodies[i]->GetAngle() : 0.0f;
+        poses.push_back({world.getMovingObstaclePosition(i), angle});
+    }
+    return poses;
+}
+
+// Every static piece of the level lands on one compound body, and the
+// level costs one body for its scenery plus one per mover
+void testStaticObstaclesShareOneBody() {
+    LevelManager emptyLevels;
+    PhysicsWorld empty;
+    LevelSimulation emptySimulation(&empty, &emptyLevels);
+    CHECK(setupObstacleLevel(emptyLevels, emptySimulation, false));
+
+    LevelManager levels;
+    PhysicsWorld world;
+    LevelSimulation simulation(&world, &levels);
+    CHECK(setupObstacleLevel(levels, simulation, true));
+
+    const Level* level = levels.getCurrentLevel();
+    std::vector<ObstacleData> obstacles = makeObstacles(level->getWidth(), level->getHeight());
+    int staticCount = 0;
+    int moverCount = 0;
+    for (const ObstacleData& obstacle : obstacles) {
+        if (obstacle.isMoving) {
+            moverCount++;
+        } else {
+            staticCount++;
+        }
+    }
+
+    CHECK(world.getMovingObstacleCount() == static_cast<size_t>(moverCount));
+    CHECK(world.getBox2DWorld()->GetBodyCount() ==
+          empty.getBox2DWorld()->GetBodyCount() + 1 + moverCount);
+    CHECK(kinematicBodies(world).size() == static_cast<size_t>(moverCount));
+
+    // Each piece is where the level put it, and all on the same body
+    const b2Body* compound = nullptr;
+    for (const ObstacleData& obstacle : obstacles) {
+        if (obstacle.isMoving) continue;
+        const b2Body* body = staticBodyAt(world, obstacle.position);
+        CHECK(body != nullptr);
+        if (!compound) compound = body;
+        CHECK(body == compound);
+    }
+    CHECK(compound && fixtureCount(compound) == staticCount);
+
+    // The tilted box keeps its rotation on the compound body: it covers a
+    // point along its rotated axis and misses one along the unrotated axis
+    const ObstacleData& tilted = obstacles[2];
+    float reach = tilted.size.x * 0.4f;
+    Vec2 axis(std::cos(tilted.rotation), std::sin(tilted.rotation));
+    CHECK(staticBodyAt(world, tilted.position + axis * reach) == compound);
+    CHECK(staticBodyAt(world, tilted.position + Vec2(reach, 0.0f)) == nullptr);
+
+    // Clearing takes the compound body and the movers out of the world
+    world.clearObstacles();
+    CHECK(world.getMovingObstacleCount() == 0);
+    CHECK(world.getBox2DWorld()->GetBodyCount() == empty.getBox2DWorld()->GetBodyCount());
+}
+
+// Movers sit on their precomputed path every tick, through more than one
+// round trip, and a restored snapshot puts them back where they were at
+// capture and on the same path from there
+void testMoversFollowPathAndRestore() {
+    LevelManager levels;
+    PhysicsWorld world;
+    LevelSimulation simulation(&world, &levels);
+    CHECK(setupObstacleLevel(levels, simulation, true));
+    world.setStepBudget(PHYSICS_MAX_SUBSTEPS, 0.0f);
+
+    const Level* level = levels.getCurrentLevel();
+    std::vector<ObstacleData> movers;
+    for (const ObstacleData& obstacle : makeObstacles(level->getWidth(), level->getHeight())) {
+        if (obstacle.isMoving) movers.push_back(obstacle);
+    }
+    CHECK(world.getMovingObstacleCount() == movers.size());
+
+    const float timestep = world.getTimestep();
+    const int roundTrip = static_cast<int>(std::lround(2.0f * MOVER_DISTANCE / MOVER_SPEED / timestep));
+    std::vector<MoverPose> startPoses = moverPoses(world);
+
+    WorldSnapshot snapshot;
+    std::vector<std::vector<MoverPose>> afterCapture;
+    for (int i = 0; i < roundTrip * 2 + roundTrip / 3; ++i) {
+        world.update(timestep);
+        for (size_t m = 0; m < movers.size(); ++m) {
+            Vec2 expected = expectedMoverPosition(movers[m], world.getTick(), timestep);
+            Vec2 actual = world.getMovingObstaclePosition(m);
+            CHECK_NEAR(actual.x, expected.x, 0.05);
+            CHECK_NEAR(actual.y, expected.y, 0.05);
+        }
+        if (i == roundTrip / 2 + 7) {
+            world.captureSnapshot(snapshot);
+        } else if (snapshot.valid && afterCapture.size() < 30) {
+            afterCapture.push_back(moverPoses(world));
+        }
+    }
+
+    // After whole round trips a mover is back at its start, angle unchanged
+    std::vector<MoverPose> poses = moverPoses(world);
+    for (size_t m = 0; m < movers.size() && m < startPoses.size(); ++m) {
+        CHECK_NEAR(startPoses[m].angle, poses[m].angle, 1e-6);
+    }
+
+    CHECK(world.restoreSnapshot(snapshot));
+    std::vector<MoverPose> capturePoses = moverPoses(world);
+    CHECK(world.getTick() == snapshot.tick);
+    for (size_t m = 0; m < movers.size() && m < capturePoses.size(); ++m) {
+        Vec2 expected = expectedMoverPosition(movers[m], snapshot.tick, timestep);
+        CHECK_NEAR(capturePoses[m].position.x, expected.x, 0.05);
+        CHECK_NEAR(capturePoses[m].position.y, expected.y, 0.05);
+        CHECK_NEAR(capturePoses[m].angle, startPoses[m].angle, 1e-6);
+    }
+
+    // Stepping on from the restore repeats the ticks that followed capture
+    for (size_t i = 0; i < afterCapture.size(); ++i) {
+        world.update(timestep);
+        std::vector<MoverPose> replayed = moverPoses(world);
+        for (size_t m = 0; m < replayed.size() && m < afterCapture[i].size(); ++m) {
+            CHECK_NEAR(replayed[m].position.x, afterCapture[i][m].position.x, 0.05);
+            CHECK_NEAR(replayed[m].position.y, afterCapture[i][m].position.y, 0.05);
+            CHECK_NEAR(replayed[m].angle, afterCapture[i][m].angle, 1e-6);
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    testStaticObstaclesShareOneBody();
+    testMoversFollowPathAndRestore();
+    return testResult();
+}
@@ -0,0 +1,97 @@
+#include "GravityPaint/physics/PhysicsWorld.h"
+#include "GravityPaint/physics/PhysicsObject.h"
+#include "TestCheck.h"
+
+using namespace GravityPaint;
+
+namespace {
+
+constexpr float WORLD_WIDTH = 800.0f;
+constexpr float WORLD_HEIGHT = 600.0f;
+
+void stepTicks(PhysicsWorld& world, int ticks) {
+    for (int i = 0; i < ticks; ++i) {
+        world.update(world.getTimestep());
+    }
+}
+
+bool isAsleep(PhysicsWorld& world, ObjectHandle handle) {
+    const PhysicsObject* object = world.getObject(handle);
+    return object && object->getBody() && !object->getBody()->IsAwake();
+}
+
+// A ball left alone with no gravity, stepped until Box2D puts it to sleep
+ObjectHandle createSleepingBall(PhysicsWorld& world) {
+    CHECK(world.initialize());
+    world.setStepBudget(PHYSICS_MAX_SUBSTEPS, 0.0f);
+    world.setGlobalGravity(Vec2(0.0f, 0.0f));
+    world.createBoundaries(WORLD_WIDTH, WORLD_HEIGHT);
+
+    ObjectHandle handle = world.createObject(ObjectType::Ball, Vec2(400.0f, 300.0f), 1.0f);
+    for (int i = 0; i < 60 * 5 && !isAsleep(world, handle); ++i) {
+        stepTicks(world, 1);
+    }
+    CHECK(isAsleep(world, handle));
+    return handle;
+}
+
+// A field pulling at half the wake threshold leaves the ball asleep and
+// where it was; the pull is only counted as skipped
+void testWeakPullLeavesSleeperAsleep() {
+    PhysicsWorld world;
+    ObjectHandle handle = createSleepingBall(world);
+    Vec2 start = world.getObject(handle)->getPosition();
+
+    world.createGravityField(Vec2(400.0f, 300.0f), Vec2(1.0f, 0.0f),
+                             PHYSICS_WAKE_ACCELERATION * 0.5f, 300.0f);
+    world.resetStepStats();
+    stepTicks(world, 60 * 3);
+
+    CHECK(isAsleep(world, handle));
+    CHECK(world.getStepStats().sleepingSkips > 0);
+    CHECK(world.getStepStats().reducedRateSkips > 0);
+    Vec2 end = world.getObject(handle)->getPosition();
+    CHECK_NEAR(end.x, start.x, 1e-4);
+    CHECK_NEAR(end.y, start.y, 1e-4);
+}
+
+// The same pull with LOD off is applied, waking the ball and moving it
+void testWeakPullWakesWithLodOff() {
+    PhysicsWorld world;
+    ObjectHandle handle = createSleepingBall(world);
+    Vec2 start = world.getObject(handle)->getPosition();
+
+    world.setLodEnabled(false);
+    world.createGravityField(Vec2(400.0f, 300.0f), Vec2(1.0f, 0.0f),
+                             PHYSICS_WAKE_ACCELERATION * 0.5f, 300.0f);
+    world.resetStepStats();
+    stepTicks(world, 60);
+
+    CHECK(!isAsleep(world, handle));
+    CHECK(world.getStepStats().sleepingSkips == 0);
+    CHECK(world.getStepStats().reducedRateSkips == 0);
+    CHECK(world.getObject(handle)->getPosition().x > start.x);
+}
+
+// A pull above the threshold wakes the ball with LOD on
+void testStrongPullWakesSleeper() {
+    PhysicsWorld world;
+    ObjectHandle handle = createSleepingBall(world);
+    Vec2 start = world.getObject(handle)->getPosition();
+
+    world.createGravityField(Vec2(400.0f, 300.0f), Vec2(1.0f, 0.0f),
+                             MAX_GRAVITY_STRENGTH, 300.0f);
+    stepTicks(world, 60);
+
+    CHECK(!isAsleep(world, handle));
+    CHECK(world.getObject(handle)->getPosition().x > start.x);
+}
+
+} // namespace
+
+int main() {
+    testWeakPullLeavesSleeperAsleep();
+    testWeakPullWakesWithLodOff();
+    testStrongPullWakesSleeper();
+    return testResult();
+}
@@ -0,0 +1,80 @@
+#include "GravityPaint/physics/PhysicsWorld.h"
+#include "GravityPaint/physics/PhysicsObject.h"
+#include "TestCheck.h"
+#include <random>
+#include <vector>
+
+using namespace GravityPaint;
+
+namespace {
+
+// Balls on a 60 px grid with gaps between them, so every point is inside
+// at most one object and the batched and single lookups must agree
+void fillGrid(PhysicsWorld& world) {
+    for (int row = 0; row < 8; ++row) {
+        for (int column = 0; column < 12; ++column) {
+            world.createObject(ObjectType::Ball,
+                               Vec2(60.0f + 60.0f * static_cast<float>(column),
+                                    60.0f + 60.0f * static_cast<float>(row)),
+                               1.0f);
+        }
+    }
+}
+
+void checkMatchesSingle(PhysicsWorld& world, const std::vector<Vec2>& points) {
+    std::vector<PhysicsObject*> results(points.size(), nullptr);
+    world.getObjectsAtPoints(points.data(), points.size(), results.data());
+    for (size_t i = 0; i < points.size(); ++i) {
+        CHECK(results[i] == world.getObjectAtPoint(points[i]));
+    }
+}
+
+void testBatchMatchesSingleLookups() {
+    PhysicsWorld world;
+    CHECK(world.initialize());
+    world.createBoundaries(800.0f, 600.0f);
+    world.createGoalZone(Vec2(240.0f, 240.0f), Vec2(200.0f, 200.0f));
+    fillGrid(world);
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> spread(0.0f, 800.0f);
+    std::uniform_real_distribution<float> cluster(200.0f, 320.0f);
+
+    // Spread out, clustered (partly under the goal sensor), and a mix
+    // with repeated points and points sharing an x
+    std::vector<Vec2> spreadPoints, clusterPoints;
+    for (int i = 0; i < 200; ++i) {
+        spreadPoints.push_back(Vec2(spread(rng), spread(rng) * 0.75f));
+        clusterPoints.push_back(Vec2(cluster(rng), cluster(rng)));
+    }
+    std::vector<Vec2> mixed = {
+        Vec2(60.0f, 60.0f), Vec2(60.0f, 60.0f), Vec2(60.0f, 120.0f), Vec2(60.0f, 90.0f),
+        Vec2(90.0f, 90.0f), Vec2(725.0f, 480.0f), Vec2(-50.0f, 300.0f), Vec2(120.0f, 60.0f),
+    };
+
+    checkMatchesSingle(world, spreadPoints);
+    checkMatchesSingle(world, clusterPoints);
+    checkMatchesSingle(world, mixed);
+
+    // Ball centres always hit, the gaps between them never do
+    std::vector<PhysicsObject*> results(mixed.size(), nullptr);
+    world.getObjectsAtPoints(mixed.data(), mixed.size(), results.data());
+    CHECK(results[0] != nullptr);
+    CHECK(results[1] == results[0]);
+    CHECK(results[2] != nullptr && results[2] != results[0]);
+    CHECK(results[3] == nullptr);
+    CHECK(results[4] == nullptr);
+    CHECK(results[6] == nullptr);
+
+    // No points leaves the buffer untouched
+    PhysicsObject* untouched = results[0];
+    world.getObjectsAtPoints(mixed.data(), 0, results.data());
+    CHECK(results[0] == untouched);
+}
+
+} // namespace
+
+int main() {
+    testBatchMatchesSingleLookups();
+    return testResult();
+}
@@ -0,0 +1,111 @@
+#include "GravityPaint/core/SlotMap.h"
+#include "TestCheck.h"
+#include <vector>
+
+using namespace GravityPaint;
+
+namespace {
+
+void testStaleHandleAfterRemove() {
+    SlotMap<int> map;
+    SlotHandle handle = map.emplace(7);
+    CHECK(map.contains(handle));
+    CHECK(map.remove(handle));
+
+    CHECK(!map.contains(handle));
+    CHECK(map.get(handle) == nullptr);
+    CHECK(!map.remove(handle));
+
+    // The freed slot is reused under a new generation; the old handle
+    // must not resolve to the new value
+    SlotHandle reused = map.emplace(8);
+    CHECK(reused.index == handle.index);
+    CHECK(reused.generation != handle.generation);
+    CHECK(!map.contains(handle));
+    CHECK(map.get(handle) == nullptr);
+    CHECK(map.get(reused) && *map.get(reused) == 8);
+}
+
+void testSwapRemoveKeepsMovedHandle() {
+    SlotMap<int> map;
+    std::vector<SlotHandle> handles;
+    for (int i = 0; i < 5; ++i) {
+        handles.push_back(map.emplace(i * 10));
+    }
+
+    // Removing the first value moves the last one into its place
+    CHECK(map.remove(handles[0]));
+    CHECK(map.size() == 4);
+    CHECK(map[0] == 40);
+    for (int i = 1; i < 5; ++i) {
+        CHECK(map.contains(handles[i]));
+        CHECK(map.get(handles[i]) && *map.get(handles[i]) == i * 10);
+        CHECK(map.atSlot(handles[i].index) == i * 10);
+    }
+    CHECK(map.handleAt(0) == handles[4]);
+
+    // Removing the last value moves nothing
+    CHECK(map.remove(handles[3]));
+    CHECK(map.get(handles[4]) && *map.get(handles[4]) == 40);
+    CHECK(map.get(handles[1]) && *map.get(handles[1]) == 10);
+}
+
+void testClearBumpsGenerations() {
+    SlotMap<int> map;
+    std::vector<SlotHandle> handles;
+    for (int i = 0; i < 4; ++i) {
+        handles.push_back(map.emplace(i));
+    }
+    map.remove(handles[2]);
+    SlotHandle removed = handles[2];
+
+    map.clear();
+    CHECK(map.empty());
+    for (const SlotHandle& handle : handles) {
+        CHECK(!map.contains(handle));
+        CHECK(map.get(handle) == nullptr);
+    }
+
+    // Every slot comes back with a generation none of the old handles have
+    for (int i = 0; i < 4; ++i) {
+        SlotHandle fresh = map.emplace(100 + i);
+        for (const SlotHandle& handle : handles) {
+            CHECK(fresh != handle);
+        }
+        CHECK(fresh != removed);
+        CHECK(map.contains(fresh));
+    }
+    for (const SlotHandle& handle : handles) {
+        CHECK(!map.contains(handle));
+    }
+}
+
+void testGenerationZeroNeverValid() {
+    SlotMap<int> map;
+    SlotHandle none;
+    CHECK(!map.contains(none));
+
+    SlotHandle handle = map.emplace(1);
+    CHECK(handle.generation != 0);
+    CHECK(!map.contains(none));
+    CHECK(map.get(none) == nullptr);
+    CHECK(!map.remove(none));
+
+    // Churn one slot many times: its generation never comes back to 0
+    for (int i = 0; i < 1000; ++i) {
+        CHECK(map.remove(handle));
+        handle = map.emplace(i);
+        CHECK(handle.generation != 0);
+    }
+    CHECK(!map.contains(SlotHandle{handle.index, 0}));
+}
+
+} // namespace
+
+int main() {
+    testStaleHandleAfterRemove();
+    testSwapRemoveKeepsMovedHandle();
+    testClearBumpsGenerations();
+    testGenerationZeroNeverValid();
+    return testResult();
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdio>
+
+// Minimal checks for the simulation tests. A failed CHECK reports and
+// carries on so one run shows every failure; main() returns
+// testResult() so ctest sees the outcome.
+
+namespace GravityPaint {
+
+inline int& testFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+inline int testResult() {
+    if (testFailures() > 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", testFailures());
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace GravityPaint
+
+#define CHECK(condition)                                                              \
+    do {                                                                              \
+        if (!(condition)) {                                                           \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            ++GravityPaint::testFailures();                                           \
+        }                                                                             \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tolerance)                                                   \
+    do {                                                                              \
+        double checkA_ = (a);                                                         \
+        double checkB_ = (b);                                                         \
+        if (!(checkA_ - checkB_ <= (tolerance) && checkB_ - checkA_ <= (tolerance))) { \
+            std::fprintf(stderr, "%s:%d: CHECK_NEAR(%s, %s) failed: %g vs %g\n",      \
+                         __FILE__, __LINE__, #a, #b, checkA_, checkB_);               \
+            ++GravityPaint::testFailures();                                           \
+        }                                                                             \
+    } while (0)